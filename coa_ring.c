@@ -0,0 +1,298 @@
+/*
+ * com_on_air_cs - basic driver for the Dosch and Amand "com on air" cards
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * authors:
+ * (C) 2008  Andreas Schuler <krater at badterrorist dot com>
+ * (C) 2008  Matthias Wenzel <dect at mazzoo dot de>
+ *
+ */
+
+/*
+ * the rx ring is one vmalloc_user() area: a header page with the
+ * producer/consumer indices, followed by fixed-size record slots.
+ * the whole area can be mmap()ed read only, so a reader may consume
+ * records in place instead of read()ing them.
+ *
+ * there is exactly one producer (the interrupt handler or the sniffer
+ * tasklet), which owns head and never waits for anybody. every
+ * consumer brings its own struct coa_ring_reader. a consumer that falls
+ * more than mask records behind finds its oldest records overwritten;
+ * it skips them and counts them as its own drops.
+ *
+ * a record is copied out in place and checked afterwards: if head has
+ * moved on by a whole ring meanwhile, the producer may have been
+ * writing into it and the copy is thrown away.
+ *
+ * head is the only index the two sides share, there is no lock. the
+ * producer stores it with release semantics (coa_ring_publish()), so a
+ * reader that loads it with acquire semantics (coa_ring_head()) sees
+ * every slot it covers completely written. the driver only ever reads
+ * ring->head, hdr->head is a copy for mmap() readers and may be
+ * anything as far as the driver is concerned.
+ */
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/vmalloc.h>
+#include <linux/mm.h>
+
+#include <asm/uaccess.h>
+
+#include "coa_ring.h"
+
+
+static inline struct coa_ring_slot *coa_ring_slot(struct coa_ring *ring,
+						   uint32_t index)
+{
+	return (struct coa_ring_slot *)
+		(ring->slots + (index & ring->mask) * COA_RING_SLOTSIZE);
+}
+
+/* load head before any slot it covers */
+static inline uint32_t coa_ring_head(struct coa_ring *ring)
+{
+	uint32_t head = ring->head;
+
+	smp_rmb();
+	return head;
+}
+
+/* store head after the slots it covers. hdr->head is only exported to
+ * mmap() readers, the driver never reads it back */
+static inline void coa_ring_publish(struct coa_ring *ring, uint32_t head)
+{
+	smp_wmb();
+	ring->head = head;
+	ring->hdr->head = head;
+}
+
+int coa_ring_alloc(struct coa_ring *ring, unsigned int slots)
+{
+	if (!slots || (slots & (slots - 1)))
+		return -EINVAL;
+
+	ring->size = PAGE_SIZE + slots * COA_RING_SLOTSIZE;
+	ring->mem = vmalloc_user(ring->size);
+	if (!ring->mem)
+		return -ENOMEM;
+
+	ring->hdr   = ring->mem;
+	ring->slots = (unsigned char *)ring->mem + PAGE_SIZE;
+	ring->mask  = slots - 1;
+	ring->head  = 0;
+
+	ring->hdr->version  = COA_RING_VERSION;
+	ring->hdr->slotsize = COA_RING_SLOTSIZE;
+	ring->hdr->slots    = slots;
+	ring->hdr->offset   = PAGE_SIZE;
+	ring->hdr->head     = 0;
+	ring->hdr->tail     = 0;
+	ring->hdr->drops    = 0;
+
+	return 0;
+}
+
+void coa_ring_free(struct coa_ring *ring)
+{
+	vfree(ring->mem);
+	ring->mem = NULL;
+	ring->hdr = NULL;
+}
+
+int coa_ring_put(struct coa_ring *ring, int type, void *data, int len)
+{
+	struct coa_ring_slot *slot;
+	uint32_t head = ring->head;
+
+	if ((len < 0) || (len > sizeof(slot->data)))
+		return -EINVAL;
+
+	/* readers that see the old head must not see the slot change,
+	 * it may still hold their record head - slots */
+	smp_wmb();
+
+	slot = coa_ring_slot(ring, head);
+	slot->len  = len;
+	slot->type = type;
+	memcpy(slot->data, data, len);
+
+	coa_ring_publish(ring, head + 1);
+
+	return len;
+}
+
+/* start with the next record queued */
+void coa_ring_reader_init(struct coa_ring *ring, struct coa_ring_reader *r)
+{
+	r->tail       = ring->head;
+	r->drops      = 0;
+	r->drops_seen = 0;
+	r->batch_seq  = 0;
+}
+
+/* throw away everything queued so far, that's not a drop */
+void coa_ring_reader_flush(struct coa_ring *ring, struct coa_ring_reader *r)
+{
+	r->tail = ring->head;
+}
+
+/* skip what was overwritten, returns head. the slot at the new tail
+ * can't be the one the producer is writing to right now. */
+static uint32_t coa_ring_catch_up(struct coa_ring *ring,
+				  struct coa_ring_reader *r)
+{
+	uint32_t head = coa_ring_head(ring);
+
+	if (head - r->tail > ring->mask)
+	{
+		r->drops += head - ring->mask - r->tail;
+		r->tail   = head - ring->mask;
+	}
+	return head;
+}
+
+/* the producer lapped the record at index while we copied it */
+static inline int coa_ring_overwritten(struct coa_ring *ring, uint32_t index)
+{
+	smp_rmb();
+	return ring->head - index > ring->mask;
+}
+
+unsigned int coa_ring_reader_len(struct coa_ring *ring,
+				 struct coa_ring_reader *r)
+{
+	unsigned int len = ring->head - r->tail;
+
+	return min(len, ring->mask);
+}
+
+/* buf is a user pointer for read(), a kernel one for splice() */
+static inline int coa_ring_copy(char *buf, const void *from, size_t n, int user)
+{
+	if (user)
+		return copy_to_user((char __user *) buf, from, n) ? -EFAULT : 0;
+	memcpy(buf, from, n);
+	return 0;
+}
+
+/* copy whole records, never split one across two read()s */
+static ssize_t __coa_ring_read(struct coa_ring *ring, struct coa_ring_reader *r,
+			       char *buf, size_t count, int user)
+{
+	struct coa_ring_slot *slot;
+	unsigned int len;
+	size_t done = 0;
+
+	while (coa_ring_catch_up(ring, r) != r->tail)
+	{
+		slot = coa_ring_slot(ring, r->tail);
+		len = min_t(unsigned int, slot->len, sizeof(slot->data));
+		if (coa_ring_overwritten(ring, r->tail))
+			continue;
+		if (done + len > count)
+			break;
+		if (coa_ring_copy(buf + done, slot->data, len, user))
+			return done ? done : -EFAULT;
+		if (coa_ring_overwritten(ring, r->tail))
+			continue;
+		done += len;
+		r->tail++;
+	}
+
+	return done;
+}
+
+/* one struct coa_batch_header, followed by as many records of the same
+ * length as fit into buf */
+static ssize_t __coa_ring_read_batch(struct coa_ring *ring,
+				     struct coa_ring_reader *r,
+				     char *buf, size_t count, int user)
+{
+	struct coa_batch_header batch;
+	struct coa_ring_slot *slot;
+	unsigned int len;
+	size_t done = sizeof(batch);
+
+	batch.version = COA_PACKET_VERSION;
+	batch.reclen  = 0;
+	batch.count   = 0;
+
+	while (coa_ring_catch_up(ring, r) != r->tail)
+	{
+		slot = coa_ring_slot(ring, r->tail);
+		len = min_t(unsigned int, slot->len, sizeof(slot->data));
+		if (coa_ring_overwritten(ring, r->tail))
+			continue;
+		if (!batch.count)
+		{
+			if (count < sizeof(batch) + len)
+				return -EINVAL;
+			batch.reclen = len;
+		}
+		if ( (len != batch.reclen) ||
+		     (done + len > count) )
+			break;
+		if (coa_ring_copy(buf + done, slot->data, len, user))
+			return -EFAULT;
+		if (coa_ring_overwritten(ring, r->tail))
+			continue;
+		done += len;
+		batch.count++;
+		r->tail++;
+	}
+
+	if (!batch.count)
+		return 0;
+
+	batch.drops = r->drops - r->drops_seen;
+	batch.seq   = r->batch_seq++;
+	r->drops_seen = r->drops;
+
+	if (coa_ring_copy(buf, &batch, sizeof(batch), user))
+		return -EFAULT;
+
+	return done;
+}
+
+ssize_t coa_ring_read(struct coa_ring *ring, struct coa_ring_reader *r,
+		      char __user *buf, size_t count)
+{
+	return __coa_ring_read(ring, r, (char __force *) buf, count, 1);
+}
+
+ssize_t coa_ring_read_batch(struct coa_ring *ring, struct coa_ring_reader *r,
+			    char __user *buf, size_t count)
+{
+	return __coa_ring_read_batch(ring, r, (char __force *) buf, count, 1);
+}
+
+ssize_t coa_ring_read_kernel(struct coa_ring *ring, struct coa_ring_reader *r,
+			     void *buf, size_t count)
+{
+	return __coa_ring_read(ring, r, buf, count, 0);
+}
+
+ssize_t coa_ring_read_batch_kernel(struct coa_ring *ring,
+				   struct coa_ring_reader *r,
+				   void *buf, size_t count)
+{
+	return __coa_ring_read_batch(ring, r, buf, count, 0);
+}
+
+/* read only: the slots are only ever written by the driver */
+int coa_ring_mmap(struct coa_ring *ring, struct vm_area_struct *vma)
+{
+	unsigned long size = vma->vm_end - vma->vm_start;
+
+	if (vma->vm_pgoff || size > PAGE_ALIGN(ring->size))
+		return -EINVAL;
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	return remap_vmalloc_range(vma, ring->mem, 0);
+}
@@ -0,0 +1,64 @@
+/*
+ * com_on_air_cs - basic driver for the Dosch and Amand "com on air" cards
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * authors:
+ * (C) 2008  Andreas Schuler <krater at badterrorist dot com>
+ * (C) 2008  Matthias Wenzel <dect at mazzoo dot de>
+ *
+ */
+
+#ifndef COA_RING_H
+#define COA_RING_H
+
+#include <linux/kernel.h>
+#include <linux/fs.h>
+#include <linux/mm.h>
+
+#include "com_on_air_user.h"
+
+struct coa_ring
+{
+	void                    *mem;   /* header page + slots, vmalloc_user() */
+	size_t                  size;
+	struct coa_ring_header  *hdr;
+	unsigned char           *slots;
+	unsigned int            mask;
+	uint32_t                head;   /* the real one, hdr->head is a copy */
+};
+
+/* one per reader, the ring itself doesn't know its readers */
+struct coa_ring_reader
+{
+	uint32_t                tail;
+	uint32_t                drops;  /* records overwritten before read */
+
+	/* bookkeeping for batch reads */
+	uint32_t                drops_seen;
+	uint32_t                batch_seq;
+};
+
+int          coa_ring_alloc(struct coa_ring *ring, unsigned int slots);
+void         coa_ring_free(struct coa_ring *ring);
+int          coa_ring_put(struct coa_ring *ring, int type, void *data, int len);
+int          coa_ring_mmap(struct coa_ring *ring, struct vm_area_struct *vma);
+
+void         coa_ring_reader_init(struct coa_ring *ring, struct coa_ring_reader *r);
+void         coa_ring_reader_flush(struct coa_ring *ring, struct coa_ring_reader *r);
+unsigned int coa_ring_reader_len(struct coa_ring *ring, struct coa_ring_reader *r);
+ssize_t      coa_ring_read(struct coa_ring *ring, struct coa_ring_reader *r,
+			   char __user *buf, size_t count);
+ssize_t      coa_ring_read_batch(struct coa_ring *ring, struct coa_ring_reader *r,
+				 char __user *buf, size_t count);
+
+/* the same into kernel memory, for splice() */
+ssize_t      coa_ring_read_kernel(struct coa_ring *ring, struct coa_ring_reader *r,
+				  void *buf, size_t count);
+ssize_t      coa_ring_read_batch_kernel(struct coa_ring *ring,
+					struct coa_ring_reader *r,
+					void *buf, size_t count);
+
+#endif
@@ -18,8 +18,17 @@
 #include <linux/init.h>
 #include <linux/fs.h>
 #include <linux/crc32.h>
-#include <linux/kfifo.h>
 #include <linux/poll.h>
+#include <linux/ktime.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/device.h>
+#include <linux/mutex.h>
+#include <linux/mm.h>
+#include <linux/pipe_fs_i.h>
+#include <linux/splice.h>
+#include <linux/log2.h>
+#include <linux/firmware.h>
 
 #include <pcmcia/cs_types.h>
 #include <pcmcia/cs.h>
@@ -35,6 +44,7 @@
 #include "com_on_air_user.h" /* ioctls ... */
 #include "sc14421.h"
 #include "sc14421_sniffer.h"
+#include "sc14421_loader.h"
 
 
 MODULE_AUTHOR("Matthias Wenzel comonair<a>mazzoo.de;"
@@ -43,17 +53,163 @@ MODULE_DESCRIPTION("Dosch&Amand COM-ON-AIR PCMCIA driver");
 MODULE_LICENSE("GPL");
 
 #define COA_DEVICE_NAME "com_on_air_cs"
-#define COA_FIFO_SIZE 65536
+#define COA_MAJOR 0xDEC
 
-struct coa_info *dev;
+/* records in the rx ring of each card, rounded up to a power of two */
+static unsigned int ring_slots = 1024;
+module_param(ring_slots, uint, S_IRUGO);
+MODULE_PARM_DESC(ring_slots, "records in the rx ring of each card (default 1024)");
 
+/* read the sync sniffer's slot buffers with one memcpy_fromio() each
+ * instead of word by word, see COA_IOCTL_READ_BENCH */
+static int burst_read = 1;
+module_param(burst_read, bool, S_IRUGO | S_IWUSR);
+MODULE_PARM_DESC(burst_read, "burst DIP RAM reads, taken at sniffer start (default 1)");
 
+/* one entry per card slot, indexed by minor. entries are allocated on
+ * the first probe and stay around until unload, so open files survive
+ * an eject. dev->p_dev tells whether a card is inserted. */
+static struct coa_info *coa_cards[COA_MAX_CARDS];
+static DEFINE_MUTEX(coa_cards_lock);
 
+static struct class *coa_class;
+static struct dentry *coa_debugfs_root;
+
+
+/* records are queued, and either enough of them or the oldest one has
+ * waited long enough (see struct coa_watermark) */
+static int coa_rx_ready(struct coa_reader *r)
+{
+	unsigned int len = coa_ring_reader_len(&r->dev->rx_ring, &r->ring);
+
+	return (len >= r->wake_packets) || (len && r->timed_out);
+}
+
+/* called from the interrupt handler and the sniffer tasklet after new
+ * records were queued. one wakeup serves all readers, each of them
+ * checks its own watermark. */
+void coa_rx_wakeup(struct coa_info *dev)
+{
+	struct coa_reader *r;
+	unsigned long flags;
+	unsigned int len;
+	int wake = 0;
+
+	spin_lock_irqsave(&dev->readers_lock, flags);
+	list_for_each_entry(r, &dev->readers, list)
+	{
+		len = coa_ring_reader_len(&dev->rx_ring, &r->ring);
+		if (len > dev->stats.ring_high)
+			dev->stats.ring_high = len;
+
+		if (!len)
+			continue;
+		if (len >= r->wake_packets)
+			wake = 1;
+		else if (r->wake_usecs && !timer_pending(&r->timer))
+			mod_timer(&r->timer,
+				  jiffies + usecs_to_jiffies(r->wake_usecs));
+	}
+	spin_unlock_irqrestore(&dev->readers_lock, flags);
+
+	if (wake)
+		wake_up_interruptible(&dev->rx_wait);
+}
+
+static void coa_rx_timeout(unsigned long data)
+{
+	struct coa_reader *r = (struct coa_reader *) data;
+
+	r->timed_out = 1;
+	wake_up_interruptible(&r->dev->rx_wait);
+}
+
+/* drop whatever is queued for every reader, e.g. on a mode change */
+static void coa_rx_flush(struct coa_info *dev)
+{
+	struct coa_reader *r;
+	unsigned long flags;
+
+	spin_lock_irqsave(&dev->readers_lock, flags);
+	list_for_each_entry(r, &dev->readers, list)
+		coa_ring_reader_flush(&dev->rx_ring, &r->ring);
+	spin_unlock_irqrestore(&dev->readers_lock, flags);
+}
+
+/* fold the reader's new drops into the card statistics */
+static void coa_rx_count_drops(struct coa_reader *r)
+{
+	struct coa_info *dev = r->dev;
+	unsigned long flags;
+
+	spin_lock_irqsave(&dev->readers_lock, flags);
+	dev->stats.ring_drops += r->ring.drops - r->drops_counted;
+	r->drops_counted = r->ring.drops;
+	spin_unlock_irqrestore(&dev->readers_lock, flags);
+}
+
+/* queue a byte stream for read(), cut into records of up to a slot.
+ * the ring has a single producer, so the interrupt handler and the
+ * sniffer tasklet are held off meanwhile. */
+static void coa_rx_queue_bytes(struct coa_info *dev, const void *data, int len)
+{
+	const unsigned char *p = data;
+	int n;
+
+	disable_irq(dev->irq);
+	tasklet_disable(&dev->sniffer_tasklet);
+	while (len > 0)
+	{
+		n = min(len, COA_RING_SLOTSIZE - 4);
+		coa_ring_put(&dev->rx_ring, COA_RECORD_BYTES, (void *) p, n);
+		p   += n;
+		len -= n;
+	}
+	tasklet_enable(&dev->sniffer_tasklet);
+	enable_irq(dev->irq);
+
+	coa_rx_wakeup(dev);
+}
+
+
+/* any number of files may be open per card, each one reads all records */
 static int coa_open(struct inode *inode, struct file *filp)
 {
-	if (dev->open)
-		return -EBUSY;
-	dev->open = 1;
+	unsigned int minor = iminor(inode);
+	struct coa_info *dev;
+	struct coa_reader *r;
+	unsigned long flags;
+
+	if (minor >= COA_MAX_CARDS)
+		return -ENODEV;
+
+	r = kzalloc(sizeof(*r), GFP_KERNEL);
+	if (!r)
+		return -ENOMEM;
+
+	mutex_lock(&coa_cards_lock);
+	dev = coa_cards[minor];
+	if (!dev || !dev->p_dev)
+	{
+		mutex_unlock(&coa_cards_lock);
+		kfree(r);
+		return -ENODEV;
+	}
+	dev->open++;
+	mutex_unlock(&coa_cards_lock);
+
+	r->dev = dev;
+	r->wake_packets = 1;
+	r->wake_usecs   = 0;
+	r->read_mode    = COA_READ_RECORDS;
+	setup_timer(&r->timer, coa_rx_timeout, (unsigned long) r);
+
+	spin_lock_irqsave(&dev->readers_lock, flags);
+	coa_ring_reader_init(&dev->rx_ring, &r->ring);
+	list_add_tail(&r->list, &dev->readers);
+	spin_unlock_irqrestore(&dev->readers_lock, flags);
+
+	filp->private_data = r;
 
 	return nonseekable_open(inode, filp);
 }
@@ -68,6 +224,90 @@ static int coa_open(struct inode *inode, struct file *filp)
 #define COA_IOCTL_TEST6 0xF006
 #define COA_IOCTL_TEST7 0xF007
 
+/* load the images for this card's radio, see COA_FIRMWARE_LOAD */
+static int coa_request_firmware(struct coa_info *dev)
+{
+	const struct firmware *fw;
+	const char *name;
+	int image, ret, err = 0;
+
+	for (image = 0; image < SC14421_FW_IMAGES; image++)
+	{
+		name = sc14421_fw_name(dev->radio_type, image);
+		if (!name)
+			return -ENODEV;
+
+		ret = request_firmware(&fw, name, &dev->p_dev->dev);
+		if (ret)
+		{
+			printk(COA_DEVICE_NAME": couldn't request_firmware(%s) = %d\n",
+					name, ret);
+			err = ret;
+			continue;
+		}
+
+		ret = sc14421_fw_load(dev->radio_type, image, fw->data, fw->size);
+		release_firmware(fw);
+		if (ret)
+		{
+			printk(COA_DEVICE_NAME": invalid firmware %s\n", name);
+			err = ret;
+			continue;
+		}
+		printk(COA_DEVICE_NAME": loaded %s\n", name);
+	}
+
+	return err;
+}
+
+/* the cards of a radio type share its images, restart every sniffer
+ * that runs on them */
+static void coa_restart_sniffers(unsigned int radio_type)
+{
+	struct coa_info *dev;
+	int i;
+
+	mutex_lock(&coa_cards_lock);
+	for (i = 0; i < COA_MAX_CARDS; i++)
+	{
+		dev = coa_cards[i];
+		if (!dev || !dev->p_dev || !dev->sc14421_base ||
+		    (dev->radio_type != radio_type))
+			continue;
+		if ((dev->operation_mode & COA_MODEMASK) == COA_MODE_SNIFF)
+			sniffer_init(dev);
+	}
+	mutex_unlock(&coa_cards_lock);
+}
+
+/* (re)start the sniffer in mode, carriers only matter for the rssi sweep */
+static int coa_start_sniffer(struct coa_info *dev, uint16_t mode,
+			     uint32_t carriers)
+{
+	SC14421_stop_dip(dev);
+	coa_rx_flush(dev);
+
+	/* activiate sniffer */
+
+	if (!dev->sniffer_config)
+		dev->sniffer_config =
+			kzalloc(sizeof(*dev->sniffer_config),
+				GFP_KERNEL);
+	if (!(dev->sniffer_config))
+		return -ENOMEM;
+
+	dev->sniffer_config->snifftype = mode & COA_SUBMODEMASK;
+	dev->sniffer_config->channel = 0;
+	dev->sniffer_config->rssi_carriers = carriers;
+	dev->sniffer_config->pinned = -1;
+	dev->sniffer_config->burst = burst_read;
+	dev->operation_mode = mode;
+
+	sniffer_init(dev);
+	printk(COA_DEVICE_NAME": sniffer initialized\n");
+	return 0;
+}
+
 int coa_ioctl(
 		struct inode *inode,
 		struct file *filp,
@@ -75,9 +315,11 @@ int coa_ioctl(
 		unsigned long arg)
 {
 
+	struct coa_reader *r = filp->private_data;
+	struct coa_info *dev = r->dev;
 	unsigned long __user * argp = (unsigned long __user *) arg;
 
-	if (!dev->p_dev->dev_node)
+	if (!dev->p_dev)
 		return -EIO;
 
 	switch (cmd)
@@ -95,11 +337,11 @@ int coa_ioctl(
 		{
 		case COA_MODE_IDLE:
 			printk("com_on_air_cs: stopping DIP\n");
-			SC14421_stop_dip(dev->sc14421_base);
+			SC14421_stop_dip(dev);
+			tasklet_kill(&dev->sniffer_tasklet);
 			dev->operation_mode = mode;
 
-			kfifo_reset(dev->rx_fifo);
-			kfifo_reset(dev->tx_fifo);
+			coa_rx_flush(dev);
 
 			break;
 		case COA_MODE_FP:
@@ -109,45 +351,26 @@ int coa_ioctl(
 			printk("FIXME: implement COA_MODE_PP ;)\n");
 			break;
 		case COA_MODE_SNIFF:
-
-			kfifo_reset(dev->rx_fifo);
-			kfifo_reset(dev->tx_fifo);
-
-			/* activiate sniffer */
-
-			if (!dev->sniffer_config)
-				dev->sniffer_config =
-					kzalloc(sizeof(*dev->sniffer_config),
-						GFP_KERNEL);
-			if (!(dev->sniffer_config))
-				return -ENOMEM;
-
-			dev->sniffer_config->snifftype = mode & COA_SUBMODEMASK;
-			dev->sniffer_config->channel = 0;
-			dev->operation_mode = mode;
-
-			sniffer_init(dev);
-			printk(COA_DEVICE_NAME": sniffer initialized\n");
-			break;
+			return coa_start_sniffer(dev, mode, COA_RSSI_CARRIERS_ALL);
 		case COA_MODE_EEPROM:
 		{
-			/* copy EEPROM to fifo */
+			/* copy EEPROM to the rx ring */
 #ifndef pcmcia_read_cis_mem /* not in any of my kernel headers :( */
 			int pcmcia_read_cis_mem(struct pcmcia_socket *s, int attr, u_int addr,
 					u_int len, void *ptr);
 #endif
 
-			uint8_t id = get_card_id();
+			uint8_t id = get_card_id(dev);
 			uint8_t * eeprom = kmalloc(EEPROM_SIZE, GFP_KERNEL);
 			if (!eeprom) return -ENOMEM;
-			kfifo_put(dev->rx_fifo, &id, 1);
+			coa_rx_queue_bytes(dev, &id, 1);
 			pcmcia_read_cis_mem(
 					dev->p_dev->socket,
 					1,
 					0,
 					EEPROM_SIZE,
 					eeprom);
-			kfifo_put(dev->rx_fifo, eeprom, EEPROM_SIZE);
+			coa_rx_queue_bytes(dev, eeprom, EEPROM_SIZE);
 			kfree(eeprom);
 			break;
 		}
@@ -197,6 +420,8 @@ int coa_ioctl(
 			break;
 		case COA_MODE_SNIFF:
 			dev->sniffer_config->channel = channel;
+			if (!sniffer_retune(dev))
+				return 0;
 			break;
 		case COA_MODE_JAM:
 			printk("FIXME: implement COA_MODE_JAM\n");
@@ -210,15 +435,107 @@ int coa_ioctl(
 		sniffer_init(dev);
 		break;
 	}
+	case COA_IOCTL_RETUNE_BENCH:
+	{
+		/* retune to the current channel and report how long it took */
+		ktime_t start;
+		uint32_t usecs;
+		int ret;
+
+		if ((dev->operation_mode & COA_MODEMASK) != COA_MODE_SNIFF)
+			return -EINVAL;
+
+		start = ktime_get();
+		ret = sniffer_retune(dev);
+		usecs = ktime_to_us(ktime_sub(ktime_get(), start));
+		if (ret)
+			return ret;
+
+		if (copy_to_user(argp, &usecs, sizeof(usecs)))
+			return -EFAULT;
+		break;
+	}
 	case COA_IOCTL_SLOT:
-		printk("FIXME: implement COA_IOCTL_SLOT\n");
+	{
+		uint32_t slot;
+		unsigned long flags;
+		if (copy_from_user(&slot, argp, sizeof(slot)))
+		{
+			printk(COA_DEVICE_NAME": invalid argument in ioctl()\n");
+			return -EINVAL;
+		}
+		if ( (slot > 23) && (slot != COA_SLOT_ANY) )
+			return -EINVAL;
+		if (dev->operation_mode != (COA_MODE_SNIFF | COA_SUBMODE_SNIFF_SYNC))
+			return -EINVAL;
+
+		/* the tasklet owns the slottable, the irq reads the mask */
+		tasklet_disable(&dev->sniffer_tasklet);
+		spin_lock_irqsave(&dev->dip_lock, flags);
+		sniffer_pin_slot(dev, slot);
+		spin_unlock_irqrestore(&dev->dip_lock, flags);
+		tasklet_enable(&dev->sniffer_tasklet);
 		break;
-	case COA_IOCTL_RSSI:
-		printk("FIXME: implement COA_IOCTL_RSSI\n");
+	}
+	case COA_IOCTL_SCANAGG:
+	{
+		uint32_t period;
+		unsigned long flags;
+		if (copy_from_user(&period, argp, sizeof(period)))
+		{
+			printk(COA_DEVICE_NAME": invalid argument in ioctl()\n");
+			return -EINVAL;
+		}
+
+		/* the scan interrupt owns the station table */
+		spin_lock_irqsave(&dev->dip_lock, flags);
+		dev->scan_period = period;
+		if (dev->sniffer_config)
+			sniffer_scan_reset(dev);
+		spin_unlock_irqrestore(&dev->dip_lock, flags);
 		break;
+	}
+	case COA_IOCTL_RSSI:
+	{
+		uint32_t carriers;
+		if (copy_from_user(&carriers, argp, sizeof(carriers)))
+		{
+			printk(COA_DEVICE_NAME": invalid argument in ioctl()\n");
+			return -EINVAL;
+		}
+		if (!carriers)
+			carriers = COA_RSSI_CARRIERS_ALL;
+		if (carriers & ~COA_RSSI_CARRIERS_ALL)
+			return -EINVAL;
+
+		return coa_start_sniffer(dev,
+				COA_MODE_SNIFF | COA_SUBMODE_SNIFF_RSSI,
+				carriers);
+	}
 	case COA_IOCTL_FIRMWARE:
-		printk("FIXME: implement COA_IOCTL_FIRMWARE\n");
-		break;
+	{
+		uint32_t source;
+		int ret;
+		if (copy_from_user(&source, argp, sizeof(source)))
+		{
+			printk(COA_DEVICE_NAME": invalid argument in ioctl()\n");
+			return -EINVAL;
+		}
+		switch (source)
+		{
+		case COA_FIRMWARE_LOAD:
+			ret = coa_request_firmware(dev);
+			break;
+		case COA_FIRMWARE_BUILTIN:
+			ret = sc14421_fw_builtin(dev->radio_type);
+			break;
+		default:
+			return -EINVAL;
+		}
+
+		coa_restart_sniffers(dev->radio_type);
+		return ret;
+	}
 	case COA_IOCTL_SETRFPI:
 	{
 		uint8_t RFPI[5];
@@ -251,6 +568,101 @@ int coa_ioctl(
 
 		break;
 	}
+	case COA_IOCTL_WATERMARK:
+	{
+		struct coa_watermark wm;
+		if (copy_from_user(&wm, argp, sizeof(wm)))
+		{
+			printk(COA_DEVICE_NAME": invalid argument in ioctl()\n");
+			return -EINVAL;
+		}
+		/* coa_ring_reader_len() never reports more than mask */
+		if (wm.packets > dev->rx_ring.mask)
+			return -EINVAL;
+
+		r->wake_packets = wm.packets ? wm.packets : 1;
+		r->wake_usecs   = wm.usecs;
+		break;
+	}
+	case COA_IOCTL_READMODE:
+	{
+		uint32_t read_mode;
+		if (copy_from_user(&read_mode, argp, sizeof(read_mode)))
+		{
+			printk(COA_DEVICE_NAME": invalid argument in ioctl()\n");
+			return -EINVAL;
+		}
+		switch (read_mode)
+		{
+		case COA_READ_RECORDS:
+		case COA_READ_BATCH:
+			r->read_mode = read_mode;
+			break;
+		default:
+			return -EINVAL;
+		}
+		break;
+	}
+	case COA_IOCTL_FILTER:
+	{
+		struct coa_filter filter;
+		int i;
+		if (copy_from_user(&filter, argp, sizeof(filter)))
+		{
+			printk(COA_DEVICE_NAME": invalid argument in ioctl()\n");
+			return -EINVAL;
+		}
+		if (filter.count > COA_FILTER_MAX_RULES)
+			return -EINVAL;
+		if (filter.default_action > COA_FILTER_DROP)
+			return -EINVAL;
+		for (i = 0; i < filter.count; i++)
+		{
+			if ( (filter.rule[i].action > COA_FILTER_DROP) ||
+			     (filter.rule[i].bfield > COA_FILTER_BFIELD_NO) )
+				return -EINVAL;
+		}
+
+		/* the sniffer checks it from its tasklet */
+		tasklet_disable(&dev->sniffer_tasklet);
+		memcpy(&dev->filter, &filter, sizeof(dev->filter));
+		tasklet_enable(&dev->sniffer_tasklet);
+		break;
+	}
+	case COA_IOCTL_STATS:
+	{
+		struct coa_stats stats;
+
+		/* take a consistent snapshot, the counters move in the irq
+		 * and in the sniffer tasklet */
+		disable_irq(dev->irq);
+		tasklet_disable(&dev->sniffer_tasklet);
+		memcpy(&stats, &dev->stats, sizeof(stats));
+		tasklet_enable(&dev->sniffer_tasklet);
+		enable_irq(dev->irq);
+
+		if (copy_to_user((void *)arg, &stats, sizeof(stats)))
+			return -EFAULT;
+		break;
+	}
+	case COA_IOCTL_READ_BENCH:
+	{
+		struct coa_read_bench bench;
+		int ret;
+
+		if (copy_from_user(&bench, argp, sizeof(bench)))
+			return -EFAULT;
+		if ((dev->operation_mode & COA_MODEMASK) != COA_MODE_SNIFF)
+			return -EINVAL;
+
+		ret = sniffer_read_bench(dev, &bench);
+		if (ret)
+			return ret;
+
+		if (copy_to_user(argp, &bench, sizeof(bench)))
+			return -EFAULT;
+		break;
+	}
 	case COA_IOCTL_TEST7:
 	case COA_IOCTL_TEST6:
 	case COA_IOCTL_TEST5:
@@ -259,7 +671,7 @@ int coa_ioctl(
 	case COA_IOCTL_TEST2:
 	{
 		printk("\n\ncom_on_air_cs: saw %d interrupts since loading\n\n\n",
-				dev->irq_count);
+				dev->stats.irq_count);
 		break;
 	}
 	case COA_IOCTL_TEST1:
@@ -270,11 +682,7 @@ int coa_ioctl(
 				"and choose the sign of your day. "
 				"the day's divinity.\n";
 		static char * ps = teststring;
-		int ret;
-		ret = kfifo_put(dev->rx_fifo, ps, 1);
-		if (ret <= 0)
-			printk("com_on_air_cs: rx fifo full? "
-					"kfifo_put() = %d\n", ret);
+		coa_rx_queue_bytes(dev, ps, 1);
 		ps++;
 		if (!*ps)
 			ps = teststring;
@@ -283,13 +691,14 @@ int coa_ioctl(
 	case COA_IOCTL_TEST0:
 	{
 		unsigned char bank;
+		unsigned long flags;
 		int a, b, i;
 		printk("dumping complete DIP-RAM\n");
-		disable_irq(dev->irq);
+		spin_lock_irqsave(&dev->dip_lock, flags);
 		for (i = 0; i < 8; i++)
 		{
 			bank = (4 * i);
-			SC14421_switch_to_bank(dev->sc14421_base, bank);
+			SC14421_switch_to_bank(dev, bank);
 
 			printk("Setting Banking-Register to %.2x\n\n", bank);
 			for (a = 0; a < 16; a++)
@@ -308,7 +717,7 @@ int coa_ioctl(
 #endif
 			}
 		}
-		enable_irq(dev->irq);
+		spin_unlock_irqrestore(&dev->dip_lock, flags);
 		break;
 	}
 	default:
@@ -320,15 +729,17 @@ int coa_ioctl(
 
 static unsigned int coa_poll(struct file *file, poll_table * wait)
 {
+	struct coa_reader *r = file->private_data;
+	struct coa_info *dev = r->dev;
 	unsigned int mask = 0;
 
-	if (!dev->p_dev->dev_node)
+	if (!dev->p_dev)
 		return -EIO;
 
-	if (kfifo_len(dev->rx_fifo))
+	poll_wait(file, &dev->rx_wait, wait);
+
+	if (coa_rx_ready(r))
 		mask |= POLLIN  | POLLRDNORM;
-	if (COA_FIFO_SIZE - kfifo_len(dev->tx_fifo))
-		mask |= POLLOUT | POLLWRNORM;
 	return mask;
 }
 
@@ -338,41 +749,235 @@ static ssize_t coa_read(
 		size_t count_want,
 		loff_t *ppos)
 {
-	size_t to_copy;
-	size_t not_copied;
-	unsigned char *data;
+	struct coa_reader *r = filp->private_data;
+	struct coa_info *dev = r->dev;
+	ssize_t ret;
 
-	if (!dev->p_dev->dev_node)
+	if (!dev->p_dev)
 		return -EIO;
 
-	to_copy = min((size_t)kfifo_len(dev->rx_fifo), count_want);
-	data = kmalloc(to_copy, GFP_KERNEL);
-	if (!data)
-		return -ENOMEM;
+	if (!coa_rx_ready(r))
+	{
+		if (filp->f_flags & O_NONBLOCK)
+		{
+			/* below the watermark, but take what's there */
+			if (!coa_ring_reader_len(&dev->rx_ring, &r->ring))
+				return -EAGAIN;
+		}
+		else if (wait_event_interruptible(dev->rx_wait,
+				coa_rx_ready(r) || !dev->p_dev))
+			return -ERESTARTSYS;
 
-	to_copy = kfifo_get(dev->rx_fifo, data, to_copy);
-	if (to_copy < 0) {
-		kfree(data);
-		return -EIO;
+		if (!dev->p_dev)
+			return -EIO;
 	}
 
-	not_copied = copy_to_user(buf, data, to_copy);
-	kfree(data);
+	/* records go straight from the ring to userspace */
+	r->timed_out = 0;
+	if (r->read_mode == COA_READ_BATCH)
+		ret = coa_ring_read_batch(&dev->rx_ring, &r->ring, buf,
+					  count_want);
+	else
+		ret = coa_ring_read(&dev->rx_ring, &r->ring, buf, count_want);
+	if (r->ring.drops != r->drops_counted)
+		coa_rx_count_drops(r);
+	return ret;
+}
+
+static int coa_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	struct coa_reader *r = filp->private_data;
+	struct coa_info *dev = r->dev;
+
+	if (!dev->p_dev)
+		return -EIO;
 
-	return to_copy - not_copied;
+	return coa_ring_mmap(&dev->rx_ring, vma);
 }
 
+/*
+ * splice() records from the ring into a pipe, e.g. to splice() them on
+ * into a file without a round trip through userspace. every pipe
+ * buffer is a page of its own, filled with whole records (or one batch)
+ * just like read() would return them.
+ */
 
-static int coa_close(struct inode *inode, struct file *filp)
+static void coa_splice_release(struct splice_pipe_desc *spd, unsigned int i)
+{
+	__free_page(spd->pages[i]);
+}
+
+static const struct pipe_buf_operations coa_pipe_buf_ops =
+{
+	.can_merge = 0,
+	.map       = generic_pipe_buf_map,
+	.unmap     = generic_pipe_buf_unmap,
+	.confirm   = generic_pipe_buf_confirm,
+	.release   = generic_pipe_buf_release,
+	.steal     = generic_pipe_buf_steal,
+	.get       = generic_pipe_buf_get,
+};
+
+/* pages splice_to_pipe() didn't take, e.g. another writer filled the
+ * pipe meanwhile. their records become drops of the reader, and a lost
+ * batch gives back the drops its header was to report. */
+static void coa_splice_lost(struct coa_reader *r, struct splice_pipe_desc *spd,
+			    unsigned int *records, uint32_t *reported,
+			    ssize_t spliced)
+{
+	int i;
+
+	for (i = 0; i < spd->nr_pages; i++)
+	{
+		if (spliced >= (ssize_t) spd->partial[i].len)
+		{
+			spliced -= spd->partial[i].len;
+			continue;
+		}
+		spliced = 0;
+		r->ring.drops      += records[i];
+		r->ring.drops_seen -= reported[i];
+	}
+}
+
+static ssize_t coa_splice_read(
+		struct file *filp,
+		loff_t *ppos,
+		struct pipe_inode_info *pipe,
+		size_t len,
+		unsigned int flags)
 {
-	if (!dev->p_dev->dev_node)
+	struct coa_reader *r = filp->private_data;
+	struct coa_info *dev = r->dev;
+	struct page *pages[PIPE_BUFFERS];
+	struct partial_page partial[PIPE_BUFFERS];
+	struct splice_pipe_desc spd =
+	{
+		.pages       = pages,
+		.partial     = partial,
+		.nr_pages    = 0,
+		.flags       = flags,
+		.ops         = &coa_pipe_buf_ops,
+		.spd_release = coa_splice_release,
+	};
+	unsigned int records[PIPE_BUFFERS];
+	uint32_t reported[PIPE_BUFFERS];
+	uint32_t tail, drops;
+	unsigned int room, i;
+	ssize_t ret = 0;
+	int nonblock;
+
+	if (!dev->p_dev)
 		return -EIO;
-	SC14421_stop_dip(dev->sc14421_base);
 
-	dev->open = 0;
+	nonblock = (filp->f_flags & O_NONBLOCK) || (flags & SPLICE_F_NONBLOCK);
 
-	kfifo_reset(dev->rx_fifo);
-	kfifo_reset(dev->tx_fifo);
+	if (!coa_rx_ready(r))
+	{
+		if (nonblock)
+		{
+			if (!coa_ring_reader_len(&dev->rx_ring, &r->ring))
+				return -EAGAIN;
+		}
+		else if (wait_event_interruptible(dev->rx_wait,
+				coa_rx_ready(r) || !dev->p_dev))
+			return -ERESTARTSYS;
+
+		if (!dev->p_dev)
+			return -EIO;
+	}
+
+	/* records taken from the ring can't go back, so take no more than
+	 * the pipe has room for. someone else may fill it before
+	 * splice_to_pipe() runs, see coa_splice_lost(). */
+	pipe_lock(pipe);
+	room = PIPE_BUFFERS - pipe->nrbufs;
+	pipe_unlock(pipe);
+	if (!room)
+	{
+		if (nonblock)
+			return -EAGAIN;
+		room = 1; /* splice_to_pipe() waits for it */
+	}
+
+	r->timed_out = 0;
+	for (i = 0; (i < room) && len; i++)
+	{
+		size_t want = min_t(size_t, len, PAGE_SIZE);
+
+		pages[i] = alloc_page(GFP_KERNEL);
+		if (!pages[i])
+			break;
+
+		tail  = r->ring.tail;
+		drops = r->ring.drops;
+		if (r->read_mode == COA_READ_BATCH)
+			ret = coa_ring_read_batch_kernel(&dev->rx_ring,
+					&r->ring, page_address(pages[i]), want);
+		else
+			ret = coa_ring_read_kernel(&dev->rx_ring,
+					&r->ring, page_address(pages[i]), want);
+		if (ret <= 0)
+		{
+			__free_page(pages[i]);
+			break;
+		}
+
+		/* skipped records moved the tail as well */
+		records[i]  = (r->ring.tail - tail) - (r->ring.drops - drops);
+		reported[i] = 0;
+		if (r->read_mode == COA_READ_BATCH)
+			reported[i] = ((struct coa_batch_header *)
+				       page_address(pages[i]))->drops;
+
+		partial[i].offset = 0;
+		partial[i].len    = ret;
+		spd.nr_pages++;
+		len -= ret;
+	}
+
+	if (spd.nr_pages)
+	{
+		ret = splice_to_pipe(pipe, &spd);
+		coa_splice_lost(r, &spd, records, reported, ret < 0 ? 0 : ret);
+	}
+	else if (!ret)
+		ret = -EAGAIN;
+
+	if (r->ring.drops != r->drops_counted)
+		coa_rx_count_drops(r);
+
+	return ret;
+}
+
+
+static int coa_close(struct inode *inode, struct file *filp)
+{
+	struct coa_reader *r = filp->private_data;
+	struct coa_info *dev = r->dev;
+	unsigned long flags;
+
+	spin_lock_irqsave(&dev->readers_lock, flags);
+	list_del(&r->list);
+	spin_unlock_irqrestore(&dev->readers_lock, flags);
+	del_timer_sync(&r->timer);
+
+	coa_rx_count_drops(r);
+	kfree(r);
+
+	/* the last reader stops the card. it may be gone already, but
+	 * the slot must become free. */
+	mutex_lock(&coa_cards_lock);
+	if (!--dev->open)
+	{
+		if (dev->p_dev)
+			SC14421_stop_dip(dev);
+		tasklet_kill(&dev->sniffer_tasklet);
+
+		dev->filter.count = 0;
+		dev->scan_period = 0;
+	}
+	mutex_unlock(&coa_cards_lock);
 
 	return 0;
 }
@@ -385,6 +990,8 @@ static const struct file_operations coa_fops =
 	.ioctl   = coa_ioctl,
 	.poll    = coa_poll,
 	.read    = coa_read,
+	.mmap    = coa_mmap,
+	.splice_read = coa_splice_read,
 	.release = coa_close,
 };
 
@@ -399,15 +1006,35 @@ static int com_on_air_resume (struct pcmcia_device *link)
 	return 0;
 }
 
+static void coa_stats_irq_time(struct coa_info *dev, ktime_t start)
+{
+	s64 us = ktime_to_us(ktime_sub(ktime_get(), start));
+	int bucket;
+
+	if (us < 0)
+		us = 0;
+	if (us > 0xffffffff)
+		us = 0xffffffff;
+
+	bucket = fls((uint32_t) us);
+	if (bucket >= COA_STATS_IRQ_BUCKETS)
+		bucket = COA_STATS_IRQ_BUCKETS - 1;
+
+	dev->stats.irq_time[bucket]++;
+	if (us > dev->stats.irq_time_max)
+		dev->stats.irq_time_max = us;
+}
+
 static irqreturn_t
 com_on_air_irq_handler(int irq, void *dev_id)
 {
 	struct coa_info * dev = dev_id;
 
 	uint8_t dip_irq = 0;
+	ktime_t start = ktime_get();
 
-	jiffies_to_timespec(jiffies, &dev->irq_timestamp);
-	dev->irq_count++;
+	dev->irq_timestamp = ktime_to_ns(ktime_get_real());
+	dev->stats.irq_count++;
 
 	switch(dev->operation_mode & COA_MODEMASK)
 	{
@@ -419,26 +1046,237 @@ com_on_air_irq_handler(int irq, void *dev_id)
 		break;
 	case COA_MODE_SNIFF:
 		dip_irq = sniffer_irq_handler(dev);
+		coa_rx_wakeup(dev);
 		break;
 	default:
 		if (dev->sc14421_base)
 			dip_irq = SC14421_clear_interrupt(dev->sc14421_base);
 	}
 
+	coa_stats_irq_time(dev, start);
+
 	return dip_irq ? IRQ_HANDLED:IRQ_NONE;
 }
 
+/**********************************************************************/
+
+/* debugfs view of dev->stats, same numbers as COA_IOCTL_STATS */
+
+static int coa_debugfs_irq_time_show(struct seq_file *m, void *v)
+{
+	struct coa_info *dev = m->private;
+	int i;
+
+	for (i = 0; i < COA_STATS_IRQ_BUCKETS; i++)
+	{
+		if (!i)
+			seq_printf(m, "      <1us");
+		else if (i == COA_STATS_IRQ_BUCKETS - 1)
+			seq_printf(m, "  >=%5uus", 1 << (i - 1));
+		else
+			seq_printf(m, "%5u-%5uus", 1 << (i - 1), (1 << i) - 1);
+		seq_printf(m, " %u\n", dev->stats.irq_time[i]);
+	}
+	return 0;
+}
+
+static int coa_debugfs_slots_show(struct seq_file *m, void *v)
+{
+	struct coa_info *dev = m->private;
+	int i;
+
+	seq_printf(m, "slot         ok      error\n");
+	for (i = 0; i < 24; i++)
+		seq_printf(m, "%4d %10u %10u\n", i,
+				dev->stats.slot_ok[i],
+				dev->stats.slot_err[i]);
+	return 0;
+}
+
+static int coa_debugfs_irq_time_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, coa_debugfs_irq_time_show, inode->i_private);
+}
+
+static int coa_debugfs_slots_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, coa_debugfs_slots_show, inode->i_private);
+}
+
+static const struct file_operations coa_debugfs_irq_time_fops =
+{
+	.owner   = THIS_MODULE,
+	.open    = coa_debugfs_irq_time_open,
+	.read    = seq_read,
+	.llseek  = seq_lseek,
+	.release = single_release,
+};
+
+static const struct file_operations coa_debugfs_slots_fops =
+{
+	.owner   = THIS_MODULE,
+	.open    = coa_debugfs_slots_open,
+	.read    = seq_read,
+	.llseek  = seq_lseek,
+	.release = single_release,
+};
+
+/* debugfs is a debugging aid only, failing to set it up is not fatal */
+static void coa_debugfs_init(struct coa_info *dev)
+{
+	struct dentry *d;
+
+	char name[8];
+
+	if (!coa_debugfs_root)
+		return;
+
+	sprintf(name, "coa%d", dev->minor);
+	d = debugfs_create_dir(name, coa_debugfs_root);
+	if (!d || IS_ERR(d))
+	{
+		dev->debugfs = NULL;
+		return;
+	}
+	dev->debugfs = d;
+
+	debugfs_create_u32("irq_count",    S_IRUGO, d, &dev->stats.irq_count);
+	debugfs_create_u32("irq_time_max", S_IRUGO, d,
+			&dev->stats.irq_time_max);
+	debugfs_create_u32("overruns",     S_IRUGO, d, &dev->stats.overruns);
+	debugfs_create_u32("recovered",    S_IRUGO, d, &dev->stats.recovered);
+	debugfs_create_u32("overrun_lost", S_IRUGO, d,
+			&dev->stats.overrun_lost);
+	debugfs_create_u32("beacon_unusable", S_IRUGO, d,
+			&dev->stats.beacon_unusable);
+	debugfs_create_u32("ring_high",    S_IRUGO, d, &dev->stats.ring_high);
+	debugfs_create_u32("ring_drops",   S_IRUGO, d, &dev->stats.ring_drops);
+	debugfs_create_u32("filtered",     S_IRUGO, d, &dev->stats.filtered);
+	debugfs_create_u32("patchloops",   S_IRUGO, d, &dev->stats.patchloops);
+	debugfs_create_u32("slot_deaths",  S_IRUGO, d,
+			&dev->stats.slot_deaths);
+	debugfs_create_u32("handovers",    S_IRUGO, d, &dev->stats.handovers);
+	debugfs_create_u32("handover_frames", S_IRUGO, d,
+			&dev->stats.handover_frames);
+	debugfs_create_u32("handover_max", S_IRUGO, d,
+			&dev->stats.handover_max);
+	debugfs_create_u32("call_setups",  S_IRUGO, d,
+			&dev->stats.call_setups);
+	debugfs_create_u32("setup_frames", S_IRUGO, d,
+			&dev->stats.setup_frames);
+	debugfs_create_u32("setup_max",    S_IRUGO, d, &dev->stats.setup_max);
+	debugfs_create_u32("bank_switches", S_IRUGO, d,
+			&dev->stats.bank_switches);
+	debugfs_create_u32("bank_elided",  S_IRUGO, d,
+			&dev->stats.bank_elided);
+	debugfs_create_u32("bank_switches_frame", S_IRUGO, d,
+			&dev->stats.bank_switches_frame);
+	debugfs_create_file("irq_time", S_IRUGO, d, dev,
+			&coa_debugfs_irq_time_fops);
+	debugfs_create_file("slots", S_IRUGO, d, dev,
+			&coa_debugfs_slots_fops);
+}
+
+/**********************************************************************/
+
+/* per card state, see coa_cards[] */
+
+static struct coa_info *coa_alloc_card(int minor)
+{
+	struct coa_info *dev;
+
+	dev = kzalloc(sizeof(*dev), GFP_KERNEL);
+	if (!dev)
+		return NULL;
+
+	dev->minor = minor;
+
+	if (coa_ring_alloc(&dev->rx_ring, ring_slots))
+	{
+		printk("couldn't coa_ring_alloc(dev->rx_ring)\n");
+		kfree(dev);
+		return NULL;
+	}
+
+	init_waitqueue_head(&dev->rx_wait);
+	INIT_LIST_HEAD(&dev->readers);
+	spin_lock_init(&dev->readers_lock);
+
+	spin_lock_init(&dev->dip_lock);
+	tasklet_init(&dev->sniffer_tasklet, sniffer_tasklet, (unsigned long) dev);
+
+	coa_debugfs_init(dev);
+
+	return dev;
+}
+
+static void coa_free_card(struct coa_info *dev)
+{
+	debugfs_remove_recursive(dev->debugfs);
+
+	tasklet_kill(&dev->sniffer_tasklet);
+	sc14421_fw_forget(dev);
+	coa_ring_free(&dev->rx_ring);
+
+	kfree(dev);
+}
+
+/* claim the lowest free card slot for a freshly inserted card. a slot
+ * whose card was ejected is only reused once all its files are closed. */
+static struct coa_info *coa_get_card(struct pcmcia_device *link)
+{
+	struct coa_info *dev = NULL;
+	int i;
+
+	mutex_lock(&coa_cards_lock);
+	for (i = 0; i < COA_MAX_CARDS; i++)
+	{
+		if (!coa_cards[i])
+		{
+			coa_cards[i] = coa_alloc_card(i);
+			dev = coa_cards[i];
+			break;
+		}
+		if (!coa_cards[i]->p_dev && !coa_cards[i]->open)
+		{
+			dev = coa_cards[i];
+			break;
+		}
+	}
+	if (dev)
+		dev->p_dev = link;
+	else if (i == COA_MAX_CARDS)
+		printk("com_on_air_cs: already driving %d cards\n",
+				COA_MAX_CARDS);
+	mutex_unlock(&coa_cards_lock);
+
+	return dev;
+}
+
+static void coa_put_card(struct coa_info *dev)
+{
+	mutex_lock(&coa_cards_lock);
+	dev->p_dev = NULL;
+	mutex_unlock(&coa_cards_lock);
+}
+
 static int com_on_air_probe (struct pcmcia_device *link)
 {
+	struct coa_info *dev;
 	win_req_t req;
 	int ret;
 
-	dev->p_dev = link;
+	dev = coa_get_card(link);
+	if (!dev)
+		return -ENODEV;
 	link->priv = dev;
 
 	link->dev_node = kzalloc(sizeof(*link->dev_node), GFP_KERNEL);
 	if (!link->dev_node)
-		return -ENOMEM;
+	{
+		ret = -ENOMEM;
+		goto probe_out_5;
+	}
 
 	link->devname = kzalloc(strlen(COA_DEVICE_NAME), GFP_KERNEL);
 	if (!link->devname)
@@ -448,7 +1286,9 @@ static int com_on_air_probe (struct pcmcia_device *link)
 	}
 
 	sprintf(link->devname, COA_DEVICE_NAME);
-	sprintf(link->dev_node->dev_name, COA_DEVICE_NAME);
+	sprintf(link->dev_node->dev_name, "coa%d", dev->minor);
+	link->dev_node->major = COA_MAJOR;
+	link->dev_node->minor = dev->minor;
 
 	printk("com_on_air_cs: >>>>>>>>>>>>>>>>>>>>>>>>\n");
 	printk("com_on_air_cs: card in slot        %s\n", link->devname);
@@ -509,7 +1349,9 @@ static int com_on_air_probe (struct pcmcia_device *link)
 	link->conf.Present      = PRESENT_OPTION;
 	link->socket->functions = 0;
 
-	dev->irq_count = 0;
+	memset(&dev->stats, 0, sizeof(dev->stats));
+	dev->bank = SC14421_BANK_UNKNOWN;
+	sc14421_fw_forget(dev); /* the new card's code bank is empty */
 
 	ret = pcmcia_request_irq(link, &link->irq);
 	if (ret != 0)
@@ -599,11 +1441,11 @@ static int com_on_air_probe (struct pcmcia_device *link)
 	printk("com_on_air_cs: has%s function_config\n",
 	       (link->function_config) ? "":" no");
 
-	set_device_configbase(link->conf.ConfigBase);
+	set_device_configbase(dev, link->conf.ConfigBase);
 
 	dev->sc14421_base = ((volatile uint16_t*)(dev->membase[0]));
 
-	ret = get_card_id();
+	ret = get_card_id(dev);
 	printk("com_on_air_cs: get_card_id() = %d\n", ret);
 	switch (ret)
 	{
@@ -620,7 +1462,15 @@ static int com_on_air_probe (struct pcmcia_device *link)
 					"please update driver\n");
 	}
 	dev->card_id = ret;
+	dev->radio = sniffer_radio(dev->radio_type);
 
+	if (IS_ERR(device_create(coa_class, NULL,
+				 MKDEV(COA_MAJOR, dev->minor), dev,
+				 "coa%d", dev->minor)))
+		printk("com_on_air_cs: couldn't device_create(coa%d)\n",
+				dev->minor);
+
+	printk("com_on_air_cs: card is /dev/coa%d\n", dev->minor);
 	printk("com_on_air_cs: -----------------------\n");
 
 	return 0;
@@ -637,23 +1487,34 @@ probe_out_3:
 probe_out_4:
 	kfree(link->dev_node);
 	link->dev_node = NULL;
+probe_out_5:
+	coa_put_card(dev);
+	link->priv = NULL;
 	return ret;
 }
 
 static void com_on_air_remove(struct pcmcia_device *link)
 {
-
+	struct coa_info *dev = link->priv;
 	int j;
 
 	printk("com_on_air_cs: COM-ON-AIR card ejected\n");
 	printk("com_on_air_cs: <<<<<<<<<<<<<<<<<<<<<<<\n");
 
+	device_destroy(coa_class, MKDEV(COA_MAJOR, dev->minor));
+
+	/* quiesce the card before its windows go away: no interrupt, and
+	 * no tasklet left that patches the DIP through them */
+	if (dev->sc14421_base)
+		SC14421_stop_dip(dev);
 	if (dev->irq >= 0)
 	{
 		printk("com_on_air_cs: freeing interrupt %d\n",
 		        dev->irq);
 		free_irq(dev->irq, dev);
 	}
+	tasklet_kill(&dev->sniffer_tasklet);
+	dev->sc14421_base = NULL;
 
 	for (j=0; j<2; j++)
 	{
@@ -661,6 +1522,7 @@ static void com_on_air_remove(struct pcmcia_device *link)
 		{
 			printk("com_on_air_cs: iounmap()ing membase[%d]\n", j);
 			iounmap(dev->membase[j]);
+			dev->membase[j] = NULL;
 		}
 		if (dev->links[j])
 			if (dev->links[j]->win)
@@ -669,6 +1531,7 @@ static void com_on_air_remove(struct pcmcia_device *link)
 						j);
 				pcmcia_release_window(dev->links[j]->win);
 			}
+		dev->links[j] = NULL;
 	}
 
 	printk("com_on_air_cs: pcmcia_disable_device()\n");
@@ -691,6 +1554,12 @@ static void com_on_air_remove(struct pcmcia_device *link)
 		kfree(dev->sniffer_config);
 		dev->sniffer_config = 0;
 	}
+	dev->operation_mode = COA_MODE_IDLE;
+
+	/* kick sleeping readers, they will find the card gone */
+	coa_put_card(dev);
+	link->priv = NULL;
+	wake_up_interruptible(&dev->rx_wait);
 }
 
 static struct pcmcia_device_id com_on_air_ids[] =
@@ -733,7 +1602,7 @@ static struct pcmcia_device_id com_on_air_ids[] =
 MODULE_DEVICE_TABLE(pcmcia, com_on_air_ids);
 
 /* returns an index into com_on_air_ids[] */
-int get_card_id(void)
+int get_card_id(struct coa_info *dev)
 {
 	u32 hash[4] = { 0, 0, 0, 0};
 	int i;
@@ -787,71 +1656,70 @@ static int __init init_com_on_air_cs(void)
 	int ret = 0;
 	printk(">>> loading " COA_DEVICE_NAME "\n");
 
-	dev = kzalloc(sizeof(*dev), GFP_KERNEL);
-	if (!dev)
-		return -ENOMEM;
+	if (ring_slots < 2)
+		ring_slots = 2;
+	ring_slots = roundup_pow_of_two(ring_slots);
 
-	ret = pcmcia_register_driver(&coa_driver);
-	if (ret != 0)
-	{
-		printk("couldn't pcmcia_register_driver()\n");
-		goto init_out_3;
-	}
+	sc14421_fw_init();
 
-	ret = register_chrdev(0xDEC, COA_DEVICE_NAME, &coa_fops);
+	ret = register_chrdev(COA_MAJOR, COA_DEVICE_NAME, &coa_fops);
 	if (ret < 0)
 	{
 		printk("couldn't register_chrdev()\n");
-		goto init_out_2;
+		return ret;
 	}
 
-	spin_lock_init(&dev->rx_fifo_lock);
-	dev->rx_fifo = kfifo_alloc(COA_FIFO_SIZE, GFP_KERNEL,
-					&dev->rx_fifo_lock);
-	if (IS_ERR(dev->rx_fifo))
+	coa_class = class_create(THIS_MODULE, "coa");
+	if (IS_ERR(coa_class))
 	{
-		printk("couldn't kfifo_alloc(dev->rx_fifo)\n");
+		printk("couldn't class_create()\n");
+		ret = PTR_ERR(coa_class);
 		goto init_out_1;
 	}
 
-	spin_lock_init(&dev->tx_fifo_lock);
-	dev->tx_fifo = kfifo_alloc(COA_FIFO_SIZE, GFP_KERNEL,
-					&dev->tx_fifo_lock);
-	if (IS_ERR(dev->tx_fifo))
+	coa_debugfs_root = debugfs_create_dir(COA_DEVICE_NAME, NULL);
+	if (IS_ERR(coa_debugfs_root))
+		coa_debugfs_root = NULL;
+
+	ret = pcmcia_register_driver(&coa_driver);
+	if (ret != 0)
 	{
-		printk("couldn't kfifo_alloc(dev->tx_fifo)\n");
+		printk("couldn't pcmcia_register_driver()\n");
 		goto init_out_0;
 	}
 
 	return 0;
 
 init_out_0:
-	kfifo_free(dev->rx_fifo);
+	debugfs_remove_recursive(coa_debugfs_root);
+	class_destroy(coa_class);
 init_out_1:
-	unregister_chrdev(0xDEC, COA_DEVICE_NAME);
-init_out_2:
-	pcmcia_unregister_driver(&coa_driver);
-init_out_3:
-	kfree(dev);
+	unregister_chrdev(COA_MAJOR, COA_DEVICE_NAME);
+	sc14421_fw_exit();
 	return ret;
 }
 
 static void __exit exit_com_on_air_cs(void)
 {
-	printk("<<< unloading " COA_DEVICE_NAME "\n");
-
-	if (!dev) return;
+	int i;
 
-	unregister_chrdev(0xDEC, COA_DEVICE_NAME);
+	printk("<<< unloading " COA_DEVICE_NAME "\n");
 
 	pcmcia_unregister_driver(&coa_driver);
 
-	kfifo_free(dev->rx_fifo);
-	kfifo_free(dev->tx_fifo);
+	unregister_chrdev(COA_MAJOR, COA_DEVICE_NAME);
 
-	kfree(dev);
+	for (i = 0; i < COA_MAX_CARDS; i++)
+	{
+		if (coa_cards[i])
+			coa_free_card(coa_cards[i]);
+		coa_cards[i] = NULL;
+	}
+
+	debugfs_remove_recursive(coa_debugfs_root);
+	class_destroy(coa_class);
+	sc14421_fw_exit();
 }
 
 module_init(init_com_on_air_cs);
 module_exit(exit_com_on_air_cs);
-
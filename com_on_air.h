@@ -16,17 +16,33 @@
 
 #include <linux/kernel.h>
 #include <linux/module.h>
+#include <linux/list.h>
+#include <linux/wait.h>
+#include <linux/timer.h>
+#include <linux/interrupt.h>
+#include <linux/spinlock.h>
 #include <pcmcia/cs_types.h>
 #include <pcmcia/cs.h>
 
+#include "coa_ring.h"
+#include "com_on_air_user.h"
+
+struct sc14421_fw;
+struct sniffer_radio;
+
+/* cards handled at once, card n is minor n of the char device */
+#define COA_MAX_CARDS		4
+
 struct coa_info
 {
-	struct pcmcia_device    *p_dev;
-	int                     open;
+	struct pcmcia_device    *p_dev;  /* NULL while no card is inserted */
+	int                     minor;
+	int                     open;    /* open files, i.e. readers */
 
 	int                     irq;
-	int                     irq_count;
-	struct timespec         irq_timestamp;
+	struct coa_stats        stats;
+	struct dentry           *debugfs;
+	s64                     irq_timestamp; /* ns, ktime_get_real() */
 
 	struct pcmcia_device    *links[2];
 
@@ -36,23 +52,48 @@ struct coa_info
 
         /* hardware configs */
         unsigned short          *sc14421_base;
+        u_int                   config_base; /* io port for wait_4_IO_cycles() */
+        unsigned char           bank;    /* selected DIP bank, see sc14421.c */
+        struct sc14421_fw       *dip_fw; /* in the code bank, see sc14421_loader.c */
         unsigned int            card_id; /* index into com_on_air_ids[] */
         unsigned int            radio_type;
+        const struct sniffer_radio *radio; /* see sniffer_radio() */
 
 	unsigned int            operation_mode;
 
         /* struct fp_cfg        *fp_config; */
         /* struct pp_cfg        *pp_config; */
         struct sniffer_cfg     *sniffer_config;
+	struct coa_filter      filter;
+	uint32_t               scan_period;	/* ms, COA_IOCTL_SCANAGG */
+	struct tasklet_struct  sniffer_tasklet;
+	spinlock_t             dip_lock;	/* DIP bank register */
+
+	struct coa_ring        rx_ring;
+	wait_queue_head_t      rx_wait;
+	struct list_head       readers;
+	spinlock_t             readers_lock;
+};
+
+/* one per open file. the card's settings (mode, channel, filter) are
+ * shared, what and when read() returns is up to each reader. */
+struct coa_reader
+{
+	struct list_head       list;     /* in dev->readers */
+	struct coa_info        *dev;
+	struct coa_ring_reader ring;
+	uint32_t               drops_counted; /* already in dev->stats */
 
-	struct kfifo           *rx_fifo;
-	spinlock_t             rx_fifo_lock;
-	struct kfifo           *tx_fifo;
-	spinlock_t             tx_fifo_lock;
+	struct timer_list      timer;
+	unsigned int           timed_out;
+	unsigned int           wake_packets;
+	unsigned int           wake_usecs;
+	unsigned int           read_mode;
 };
 
 
-int get_card_id(void);
+int get_card_id(struct coa_info *dev);
+void coa_rx_wakeup(struct coa_info *dev);
 
 /* radio types */
 #define COA_RADIO_TYPE_II	0
@@ -14,6 +14,12 @@
 #ifndef COM_ON_AIR_USER_H
 #define COM_ON_AIR_USER_H
 
+#ifdef __KERNEL__
+#include <linux/types.h>
+#else
+#include <stdint.h>
+#endif
+
 /* operation modes */
 #define COA_MODEMASK			0xFF00
 #define COA_SUBMODEMASK			0x00FF
@@ -29,6 +35,7 @@
 #define COA_SUBMODE_SNIFF_SCANFP	0x0001
 #define COA_SUBMODE_SNIFF_SCANPP	0x0002
 #define COA_SUBMODE_SNIFF_SYNC		0x0003
+#define COA_SUBMODE_SNIFF_RSSI		0x0004 /* see COA_IOCTL_RSSI */
 
 
 /* ioctl */
@@ -38,11 +45,303 @@
 #define COA_IOCTL_RX			0xD002
 #define COA_IOCTL_TX			0xD003
 #define COA_IOCTL_CHAN			0xD004
-#define COA_IOCTL_SLOT			0xD005
-#define COA_IOCTL_RSSI			0xD006
-#define COA_IOCTL_FIRMWARE		0xD007 /* request_firmware() */
+#define COA_IOCTL_SLOT			0xD005 /* uint32_t, see below */
+#define COA_IOCTL_RSSI			0xD006 /* uint32_t, carrier bitmask */
+#define COA_IOCTL_FIRMWARE		0xD007 /* uint32_t, see below */
 #define COA_IOCTL_SETRFPI		0xD008
+#define COA_IOCTL_WATERMARK		0xD009 /* struct coa_watermark */
+#define COA_IOCTL_READMODE		0xD00A /* uint32_t COA_READ_* */
+#define COA_IOCTL_FILTER		0xD00B /* struct coa_filter */
+#define COA_IOCTL_STATS			0xD00C /* struct coa_stats */
+#define COA_IOCTL_RETUNE_BENCH		0xD00D /* uint32_t, usecs */
+#define COA_IOCTL_SCANAGG		0xD00E /* uint32_t, msecs, see below */
+#define COA_IOCTL_READ_BENCH		0xD00F /* struct coa_read_bench */
 
 #define EEPROM_SIZE			2048
 
+
+/* records returned by read() in sync sniff mode.
+ * this is the only definition, the driver and all tools share it.
+ * the layout is fixed (packed, no ABI dependent types), any change to
+ * it must bump COA_PACKET_VERSION. */
+
+#define COA_PACKET_VERSION		1
+
+struct coa_timestamp
+{
+	uint32_t		tv_sec;
+	uint32_t		tv_nsec;
+} __attribute__((packed));
+
+struct sniffed_packet
+{
+	uint8_t			rssi;
+	uint8_t			channel;
+	uint8_t			slot;
+	uint8_t			framenumber;
+	uint8_t			bfok;
+	struct coa_timestamp	timestamp;
+	uint8_t			data[53];
+} __attribute__((packed));
+
+
+/* COA_IOCTL_SLOT pins sync sniffing to one slot pair: slot n and n + 12
+ * for n = slot % 12. only that pair is received, until it becomes active
+ * the beacon the sniffer synced on is followed as well.
+ * COA_SLOT_ANY receives every active slot again (the default). */
+#define COA_SLOT_ANY			0xffffffff
+
+
+/* COA_IOCTL_FIRMWARE replaces the DIP programs of the card's radio type,
+ * all cards of that type share them. COA_FIRMWARE_LOAD fetches
+ * coa/sc14421_<II|III>_sniff_<scan|sync>.fw with request_firmware(),
+ * see firmware/Makefile. an image that can't be loaded keeps the current
+ * one. COA_FIRMWARE_BUILTIN returns to the images built into the module.
+ * the sniffers of all cards of that type restart on the new images. */
+#define COA_FIRMWARE_LOAD		0
+#define COA_FIRMWARE_BUILTIN		1
+
+
+/* read() modes, see COA_IOCTL_READMODE */
+#define COA_READ_RECORDS		0 /* plain records (default) */
+#define COA_READ_BATCH			1 /* header + records */
+
+/* in batch mode, every read() returns one header followed by 'count'
+ * records of 'reclen' bytes each. a read() buffer must have room for
+ * the header and at least one record. */
+struct coa_batch_header
+{
+	uint16_t		version;	/* COA_PACKET_VERSION */
+	uint16_t		reclen;		/* bytes per record */
+	uint32_t		count;		/* records following */
+	uint32_t		drops;		/* lost since the last batch */
+	uint32_t		seq;		/* batch sequence number */
+} __attribute__((packed));
+
+
+/* read()/poll() wake up once 'packets' records are queued, or 'usecs'
+ * after the first queued record, whichever comes first.
+ * usecs == 0 waits for 'packets' records only.
+ * the default is { 1, 0 }, i.e. wake up for every record. packets
+ * may be at most one less than the ring's slots.
+ * like the read() mode, the watermark belongs to the open file. */
+struct coa_watermark
+{
+	uint32_t		packets;
+	uint32_t		usecs;
+};
+
+
+/* mmap()able rx ring
+ *
+ * mmap() /dev/coa read only at offset 0 to get a struct coa_ring_header, followed
+ * (at hdr->offset) by hdr->slots records of hdr->slotsize bytes each.
+ * the driver fills slot (head % slots) and then increments head, head
+ * is a free running counter.
+ *
+ * every open file of a card reads the very same ring with a cursor of
+ * its own, so a recorder and a live viewer can attach at once. the
+ * driver never waits for a reader: once a reader is more than slots - 1
+ * records behind, the oldest records are overwritten and that reader
+ * (and only that one) loses them.
+ *
+ * read() keeps the cursor in the driver. a reader of the mapping keeps
+ * its own: copy slot (tail % slots), then re-read head, the copy is only
+ * valid if head - tail < slots still holds.
+ */
+
+#define COA_RING_VERSION		2
+#define COA_RING_SLOTSIZE		128
+
+#define COA_RECORD_STATION		1 /* 7 bytes: channel, rssi, RFPI */
+#define COA_RECORD_PACKET		2 /* struct sniffed_packet */
+#define COA_RECORD_RSSI			3 /* struct coa_rssi_row */
+#define COA_RECORD_BYTES		4 /* part of a byte stream, e.g. the
+					   * EEPROM dump of COA_MODE_EEPROM */
+#define COA_RECORD_SCAN			5 /* struct coa_scan_station */
+
+struct coa_ring_header
+{
+	uint32_t		version;
+	uint32_t		slotsize;
+	uint32_t		slots;
+	uint32_t		offset;	/* of slot 0, from start of mapping */
+	volatile uint32_t	head;	/* written by the driver */
+	volatile uint32_t	tail;	/* unused since version 2 */
+	volatile uint32_t	drops;	/* unused since version 2 */
+};
+
+struct coa_ring_slot
+{
+	uint16_t		len;	/* bytes used in data[] */
+	uint16_t		type;	/* COA_RECORD_* */
+	uint8_t			data[COA_RING_SLOTSIZE - 4];
+};
+
+
+/* capture filter for sync sniff mode, see COA_IOCTL_FILTER
+ *
+ * every packet is checked against rule[0..count-1], the first rule that
+ * matches decides, if none matches default_action does.
+ * count == 0 disables the filter.
+ * the slottable is tracked from all packets, filtered or not. */
+
+#define COA_FILTER_MAX_RULES		8
+
+#define COA_FILTER_ACCEPT		0
+#define COA_FILTER_DROP			1
+
+/* slots: bit n matches slot n, i.e. direction and timeslot */
+#define COA_FILTER_SLOTS_FP		0x000fff
+#define COA_FILTER_SLOTS_PP		0xfff000
+#define COA_FILTER_SLOTS_ALL		0xffffff
+
+/* ta: bit n matches A-field tail identification n (data[5] >> 5) */
+#define COA_FILTER_TA_CT		0x03
+#define COA_FILTER_TA_NT		0x0c
+#define COA_FILTER_TA_QT		0x10
+#define COA_FILTER_TA_MT		0x40
+#define COA_FILTER_TA_PT		0x80
+#define COA_FILTER_TA_ALL		0xff
+
+/* bfield */
+#define COA_FILTER_BFIELD_ANY		0
+#define COA_FILTER_BFIELD_YES		1
+#define COA_FILTER_BFIELD_NO		2
+
+struct coa_filter_rule
+{
+	uint32_t		slots;
+	uint8_t			ta;
+	uint8_t			bfield;
+	uint8_t			rssi_min;
+	uint8_t			action;
+};
+
+struct coa_filter
+{
+	uint32_t		count;
+	uint32_t		default_action;
+	struct coa_filter_rule	rule[COA_FILTER_MAX_RULES];
+};
+
+
+/* RSSI sweep, see COA_IOCTL_RSSI
+ *
+ * the argument is a bitmask of carriers, bit n for carrier n, 0 sweeps
+ * all of them. the card leaves its current mode and measures one carrier
+ * for two frames, the even slots and then the odd ones, before it moves
+ * to the next one. slots 11 and 23 can't be received and stay 0.
+ * every two frames read() returns one struct coa_rssi_row, 'count' rows
+ * with the same 'sweep' number make up the 24 x count energy map.
+ * slot numbers are the card's own, they are not aligned to any station.
+ */
+
+#define COA_RSSI_CARRIERS_ALL		0x0f8003ff /* 0-9, 23-27 */
+#define COA_RSSI_MAX_CARRIERS		15
+
+struct coa_rssi_row
+{
+	uint32_t		sweep;		/* sweep number */
+	struct coa_timestamp	timestamp;	/* start of the frame */
+	uint8_t			channel;	/* carrier of this row */
+	uint8_t			index;		/* row in the sweep */
+	uint8_t			count;		/* rows per sweep */
+	uint8_t			reserved;
+	uint32_t		slots;		/* bit n: rssi[n] was measured */
+	uint8_t			rssi[24];
+} __attribute__((packed));
+
+
+/* aggregated scan, see COA_IOCTL_SCANAGG
+ *
+ * the argument is a summary period in ms. once it is set, the scan modes
+ * no longer return a 7 byte record per beacon but keep track of the
+ * stations they hear, a station being an RFPI on one channel. read()
+ * then returns a struct coa_scan_station for every station heard for
+ * the first time (COA_SCAN_NEW), and once per period one for every
+ * station heard during it (COA_SCAN_SUMMARY). as the
+ * card only interrupts when it receives something, a summary goes out
+ * with the first beacon after its period is over. count and
+ * the rssi fields cover the beacons since the station's previous record,
+ * so every beacon is counted exactly once.
+ * up to COA_SCAN_MAX_STATIONS stations are tracked, beacons of any
+ * further ones are returned one by one as COA_SCAN_UNTRACKED.
+ * 0 (the default) returns to one record per beacon. setting the period
+ * forgets all stations seen so far, like starting a new scan does.
+ */
+
+#define COA_SCAN_MAX_STATIONS		256
+
+#define COA_SCAN_NEW			1
+#define COA_SCAN_SUMMARY		2
+#define COA_SCAN_UNTRACKED		3
+
+struct coa_scan_station
+{
+	uint8_t			event;		/* COA_SCAN_* */
+	uint8_t			channel;
+	uint8_t			RFPI[5];
+	uint8_t			rssi_min;
+	uint8_t			rssi_max;
+	uint8_t			reserved;
+	uint16_t		count;		/* beacons */
+	uint32_t		rssi_sum;
+	struct coa_timestamp	first_seen;
+	struct coa_timestamp	last_seen;
+} __attribute__((packed));
+
+
+/* driver statistics, see COA_IOCTL_STATS.
+ * all counters run since the card was inserted. */
+
+/* irq_time[0] counts handler runs below 1us, irq_time[n] those of
+ * [2^(n-1), 2^n) us, the last bucket everything longer */
+#define COA_STATS_IRQ_BUCKETS		16
+
+struct coa_stats
+{
+	uint32_t		irq_count;
+	uint32_t		irq_time[COA_STATS_IRQ_BUCKETS];
+	uint32_t		irq_time_max;	/* us */
+	uint32_t		overruns;	/* both halves pending at once */
+	uint32_t		bh_overruns;	/* tasklet too slow, half lost */
+	uint32_t		ring_high;	/* deepest backlog of any reader */
+	uint32_t		ring_drops;	/* records lost, summed over readers */
+	uint32_t		filtered;	/* dropped by struct coa_filter */
+	uint32_t		patchloops;	/* firmware slot patch runs */
+	uint32_t		slot_deaths;	/* slots given up after errors */
+	uint32_t		bank_switches;	/* DIP bank register writes */
+	uint32_t		bank_elided;	/* switches to the selected bank */
+	uint32_t		bank_switches_frame; /* during the last frame */
+	uint32_t		slot_ok[24];	/* A-field checksum ok */
+	uint32_t		slot_err[24];	/* A-field checksum failed */
+	uint32_t		recovered;	/* overruns read from the idle buffers */
+	uint32_t		handovers;	/* call moved to another slot pair */
+	uint32_t		handover_frames; /* frames lost in them, summed */
+	uint32_t		handover_max;	/* frames lost in the worst one */
+	uint32_t		call_setups;	/* scan pairs that got a B-field */
+	uint32_t		setup_frames;	/* frames from arming to it, summed */
+	uint32_t		setup_max;	/* frames in the slowest one */
+	uint32_t		overrun_lost;	/* halves dropped, a whole frame late */
+	uint32_t		beacon_unusable; /* beacons in slot 11 or 23, no sync */
+};
+
+
+/* DIP RAM readout timing, see COA_IOCTL_READ_BENCH.
+ * reads the slot receive buffers of the running sync or rssi firmware
+ * word by word and with one burst per buffer, slots times each, and
+ * reports the average per buffer. the module parameter burst_read picks
+ * the path the sniffer uses from the next start on. */
+#define COA_READ_BENCH_SLOTS		1024	/* slots == 0 */
+#define COA_READ_BENCH_MAX		65536
+
+struct coa_read_bench
+{
+	uint32_t		slots;		/* in */
+	uint32_t		word_ns;	/* out: per buffer, word by word */
+	uint32_t		burst_ns;	/* out: per buffer, burst and pack */
+	uint32_t		burst;		/* out: path the sniffer uses */
+};
+
 #endif
@@ -30,6 +30,7 @@
 #define DECT_Q_HEAD_MULTIFN	0x60 /* Multi Frame Number */
 
 #define DECT_Q_SSINFO_SLOT	0x0f
+#define DECT_Q_SSINFO_PSCN	0x0f
 
 
 #define DECT_P_EXTFLAG		0x80
@@ -120,6 +121,26 @@ int dect_is_multiframe_number(unsigned char *packet)
 	return 0;
 }
 
+/* the primary receiver scan carrier from an FP's static system info, the
+ * carrier the station listens on in the next frame. -1 if there is none */
+int dect_get_pscn(unsigned char *packet)
+{
+	int pscn;
+
+	if (!dect_is_fp_packet(packet))
+		return -1;
+	if ((packet[5] & DECT_A_TA) != DECT_Q_TYPE)
+		return -1;
+	if ((packet[6] & DECT_Q_HEAD) != DECT_Q_HEAD_SSINFO)
+		return -1;
+
+	pscn = packet[10] & DECT_Q_SSINFO_PSCN;
+	if (pscn >= DECT_SCAN_CARRIERS)
+		return -1;
+
+	return pscn;
+}
+
 int dect_is_fp_packet(unsigned char *packet)
 {
 	if ( (packet[3] == 0xe9) && (packet[4] == 0x8a) )
@@ -150,7 +171,7 @@ int dect_update_slottable(struct dect_slot_info *slottable, int slot, unsigned c
 		slottable[slot].errcnt = 0;
 		slottable[slot].update = 1;
 
-		if (slot > 12)
+		if (slot >= 12)
 		{
 			slottable[slot-12].type = DECT_SLOTTYPE_CARRIER;
 			if (slottable[slot-12].channel == 0)
@@ -158,7 +179,7 @@ int dect_update_slottable(struct dect_slot_info *slottable, int slot, unsigned c
 			else
 				slottable[slot-12].channel--;
 			slottable[slot-12].errcnt = 0;
-			slottable[slot].update = 1;
+			slottable[slot-12].update = 1;
 		}
 		else
 		{
@@ -168,7 +189,7 @@ int dect_update_slottable(struct dect_slot_info *slottable, int slot, unsigned c
 			else
 				slottable[slot+12].channel--;
 			slottable[slot+12].errcnt = 0;
-			slottable[slot].update = 1;
+			slottable[slot+12].update = 1;
 		}
 	}
 	
@@ -241,35 +262,8 @@ int dect_update_slottable(struct dect_slot_info *slottable, int slot, unsigned c
 			}
 
 			break;
-		case DECT_Q_TYPE:
-			if ((packet[6] & DECT_Q_HEAD) == DECT_Q_HEAD_SSINFO)
-			{
-				uint8_t pscan = packet[10];
-				int i, ret = 0;
-	
-				for (i=0; i<24; i++)
-				{
-					if (slottable[i].active)
-					{
-						if (slottable[i].type == DECT_SLOTTYPE_SCAN)
-						{
-/*							if (pscan == 0)
-								pscan = 9;
-							else
-								pscan--;
-*/
-							slottable[i].channel = pscan;
-							slottable[i].update = 1;
-							ret = 1;
-						}
-					}
-				}
-
-				return ret;			
-			}
-
-			break;
-			
+		/* the scan carrier in the static system info is followed by
+		 * the sniffer, see dect_get_pscn() */
 		}
 		
 	}
@@ -277,6 +271,33 @@ int dect_update_slottable(struct dect_slot_info *slottable, int slot, unsigned c
 	return 0;
 }
 
+/* the slot pair 0..11 an FP packet announces the call on, -1 if none */
+int dect_other_bearer(unsigned char *packet)
+{
+	if (!dect_is_fp_packet(packet))
+		return -1;
+	if ((packet[5] & DECT_A_TA) != DECT_P_TYPE)
+		return -1;
+	if ( ((packet[6] & DECT_P_HEAD) != DECT_P_HEAD_ZEROLP) &&
+	     ((packet[6] & DECT_P_HEAD) != DECT_P_HEAD_SHORTLP) )
+		return -1;
+	if ((packet[9] & DECT_P_INFOTYPE) != DECT_P_IT_OTHERBEAR)
+		return -1;
+
+	return (packet[9] & DECT_P_IT_BEARERPOS_SN) % 12;
+}
+
+/* give up both halves of a slot pair */
+void dect_retire_bearer(struct dect_slot_info *slottable, int slot)
+{
+	slot %= 12;
+
+	slottable[slot].active = 0;
+	slottable[slot].update = 1;
+	slottable[slot+12].active = 0;
+	slottable[slot+12].update = 1;
+}
+
 int dect_receive_error(struct dect_slot_info *slottable, int slot)
 {
 
@@ -325,3 +346,23 @@ int dect_update_scanchannels(struct dect_slot_info *slottable)
 
 	return ret;
 }
+
+/* put all scan slots on channel, returns 1 if any of them moved */
+int dect_set_scanchannels(struct dect_slot_info *slottable, int channel)
+{
+	int i, ret = 0;
+
+	for (i=0; i<24; i++)
+	{
+		if (slottable[i].active &&
+		    (slottable[i].type == DECT_SLOTTYPE_SCAN) &&
+		    (slottable[i].channel != channel))
+		{
+			slottable[i].channel = channel;
+			slottable[i].update = 1;
+			ret = 1;
+		}
+	}
+
+	return ret;
+}
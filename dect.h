@@ -20,6 +20,9 @@
 #define DECT_SLOTTYPE_CARRIER	0
 #define DECT_SLOTTYPE_SCAN	1
 
+/* carriers the primary receiver scan steps through, one per frame */
+#define DECT_SCAN_CARRIERS	10
+
 struct dect_slot_info
 {
 	uint8_t         active;
@@ -35,9 +38,13 @@ int dect_compare_RFPI(unsigned char *packet, unsigned char* RFPI);
 int dect_has_b_field(unsigned char *packet);
 int dect_get_slot(unsigned char *packet);
 int dect_is_multiframe_number(unsigned char *packet);
+int dect_get_pscn(unsigned char *packet);
 int dect_is_fp_packet(unsigned char *packet);
 int dect_is_pp_packet(unsigned char *packet);
 int dect_update_slottable(struct dect_slot_info *slottable, int slot, unsigned char *packet);
+int dect_other_bearer(unsigned char *packet);
+void dect_retire_bearer(struct dect_slot_info *slottable, int slot);
 int dect_receive_error(struct dect_slot_info *slottable, int slot);
 int dect_update_scanchannels(struct dect_slot_info *slottable);
+int dect_set_scanchannels(struct dect_slot_info *slottable, int channel);
 #endif
@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+/*
+ * turns the label list asl writes for a sync image into an initializer
+ * for struct sc14421_fw (sc14421_loader.h). images without a slot table
+ * (the scan images) give an empty file.
+ */
+
+#define HEADER_FMT \
+	"\n"                                         \
+	"/* automatically generated file\n"          \
+	" * DO NOT EDIT\n"                           \
+	" * edit firmware/%s.asm instead */\n"       \
+	"#define %s_LABELS \\\n"
+
+static long jump[24], patch[24], patch_b[24];
+static long recv, recv_b, recv_next, pp_found, pp_search;
+
+static void print_table(const char *name, long *table, int last)
+{
+	int slot;
+
+	printf("\t.%-9s = {", name);
+	for (slot = 0; slot < 24; slot++)
+	{
+		if (!(slot % 8))
+			printf(" \\\n\t\t");
+		else
+			printf(" ");
+		printf("0x%.2lx%s", table[slot], (slot < 23) ? "," : "");
+	}
+	printf(" \\\n\t}%s \\\n", last ? "" : ",");
+}
+
+/* <label><radio>[B] <value>, 0 if it's not one the sniffer patches */
+static int label(const char *name, const char *radio, long value)
+{
+	char l[32];
+	int n = strlen(name), r = strlen(radio);
+	int b = 0;
+	long slot;
+	char *end;
+
+	if ( (n >= sizeof(l)) || (n <= r) )
+		return 0;
+	strcpy(l, name);
+	if (l[n - 1] == 'B')
+	{
+		l[--n] = 0;
+		b = 1;
+	}
+	if ( (n <= r) || strcmp(l + n - r, radio) )
+		return 0;
+	l[n - r] = 0;
+
+	if (!strcmp(l, "Recv"))
+		*(b ? &recv_b : &recv) = value;
+	else if (b)
+	{
+		if (strncmp(l, "PP", 2))
+			return 0;
+		slot = strtol(l + 2, &end, 10);
+		if ( (end == l + 2) || *end || (slot < 0) || (slot > 23) )
+			return 0;
+		patch_b[slot] = value;
+	}
+	else if (!strcmp(l, "RecvNext"))
+		recv_next = value;
+	else if (!strcmp(l, "PPFound"))
+		pp_found = value;
+	else if (!strcmp(l, "PPSearch"))
+		pp_search = value;
+	else if (!strncmp(l, "PP", 2) || !strncmp(l, "JP", 2))
+	{
+		slot = strtol(l + 2, &end, 10);
+		if ( (end == l + 2) || *end || (slot < 0) || (slot > 23) )
+			return 0;
+		if (l[0] == 'P')
+			patch[slot] = value;
+		else
+			jump[slot] = value;
+	}
+	else
+		return 0;
+
+	return 1;
+}
+
+int main(int argc, char *argv[])
+{
+	char line[256], name[64], upper[64];
+	long value;
+	int found = 0, missing = 0;
+	int slot, i;
+	FILE *f;
+
+	if(argc<4)
+	{
+		printf("usage: label2c label-file radio image > h-file\n");
+		exit(1);
+	}
+
+	f = fopen(argv[1], "r");
+	if(!f)
+	{
+		printf("cant open(\"%s\")\n", argv[1]);
+		exit(1);
+	}
+
+	for (slot = 0; slot < 24; slot++)
+		jump[slot] = patch[slot] = patch_b[slot] = -1;
+	recv = recv_b = recv_next = pp_found = pp_search = -1;
+
+	while (fgets(line, sizeof(line), f))
+		if (2 == sscanf(line, "#define %63s %li", name, &value))
+			found += label(name, argv[2], value);
+	fclose(f);
+
+	if (!found)
+		return 0;
+
+	for (slot = 0; slot < 24; slot++)
+		missing |= (jump[slot] < 0) || (patch[slot] < 0) ||
+			   (patch_b[slot] < 0);
+	missing |= (recv < 0) || (recv_b < 0) || (recv_next < 0) ||
+		   (pp_found < 0) || (pp_search < 0);
+	if (missing)
+	{
+		fprintf(stderr, "%s: slot table labels missing\n", argv[1]);
+		exit(1);
+	}
+
+	for (i = 0; argv[3][i] && (i < sizeof(upper) - 1); i++)
+		upper[i] = toupper(argv[3][i]);
+	upper[i] = 0;
+
+	printf(HEADER_FMT, argv[3], upper);
+	print_table("jump", jump, 0);
+	print_table("patch", patch, 0);
+	print_table("patch_b", patch_b, 0);
+	printf("\t.recv      = 0x%.2lx, \\\n", recv);
+	printf("\t.recv_b    = 0x%.2lx, \\\n", recv_b);
+	printf("\t.recv_next = 0x%.2lx, \\\n", recv_next);
+	printf("\t.pp_found  = 0x%.2lx, \\\n", pp_found);
+	printf("\t.pp_search = 0x%.2lx\n", pp_search);
+	return 0;
+}
@@ -16,94 +16,138 @@ PB_RSSI			EQU		0x01
 Start:		BR	InitDIP
 ;-------------------------------------------------------------
 
+; frames alternate between SlotTable and SlotTableB. B frames receive
+; into the second buffer of each slot (0x36 on) and add U_INT2 to their
+; interrupts, so the host can read a frame until its table comes round
+; again.
+
 SlotTable:	SLOTZERO	
 JP0III:		BK_C	0x20
-PP0III:		WNT	2
+PP0III:		WNT	1
+JP1III:		BK_C	0x20
+PP1III:		WNT	1
 JP2III:		BK_C	0x30
-PP2III:		WNT	2
+PP2III:		WNT	1
+JP3III:		BK_C	0x30
+PP3III:		WNT	1
 JP4III:		BK_C	0x40
-PP4III:		WNT	2
+PP4III:		WNT	1
+JP5III:		BK_C	0x40
+PP5III:		WNT	1
 JP6III:		BK_C	0x50
-PP6III:		WNT	2
+PP6III:		WNT	1
+JP7III:		BK_C	0x50
+PP7III:		WNT	1
 JP8III:		BK_C	0x60
-PP8III:		WNT	2
+PP8III:		WNT	1
+JP9III:		BK_C	0x60
+PP9III:		WNT	1
 JP10III:	BK_C	0x70
-PP10III:	WNT	2
+PP10III:	WNT	1
+JP11III:	BK_C	0x70
+PP11III:	WNT	1
 		U_INT0	
 JP12III:	BK_C	0x80
-PP12III:	WNT	2
+PP12III:	WNT	1
+JP13III:	BK_C	0x80
+PP13III:	WNT	1
 JP14III:	BK_C	0x90
-PP14III:	WNT	2
+PP14III:	WNT	1
+JP15III:	BK_C	0x90
+PP15III:	WNT	1
 JP16III:	BK_C	0xA0
-PP16III:	WNT	2
+PP16III:	WNT	1
+JP17III:	BK_C	0xA0
+PP17III:	WNT	1
 JP18III:	BK_C	0xB0
-PP18III:	WNT	2
+PP18III:	WNT	1
+JP19III:	BK_C	0xB0
+PP19III:	WNT	1
 JP20III:	BK_C	0xC0
-PP20III:	WNT	2
+PP20III:	WNT	1
+JP21III:	BK_C	0xC0
+PP21III:	WNT	1
 JP22III:	BK_C	0xD0
-PP22III:	WNT	2
+PP22III:	WNT	1
+JP23III:	BK_C	0xD0
+PP23III:	WNT	1
             U_INT3	
             P_LDL	0x80
-			BR		SlotTable
+SlotTableB:	SLOTZERO	
+			BK_C	0x20
+PP0IIIB:	WNT	1
+			BK_C	0x20
+PP1IIIB:	WNT	1
+			BK_C	0x30
+PP2IIIB:	WNT	1
+			BK_C	0x30
+PP3IIIB:	WNT	1
+			BK_C	0x40
+PP4IIIB:	WNT	1
+			BK_C	0x40
+PP5IIIB:	WNT	1
+			BK_C	0x50
+PP6IIIB:	WNT	1
+			BK_C	0x50
+PP7IIIB:	WNT	1
+			BK_C	0x60
+PP8IIIB:	WNT	1
+			BK_C	0x60
+PP9IIIB:	WNT	1
+			BK_C	0x70
+PP10IIIB:	WNT	1
+			BK_C	0x70
+PP11IIIB:	WNT	1
+			U_INT0
+			U_INT2
+			BK_C	0x80
+PP12IIIB:	WNT	1
+			BK_C	0x80
+PP13IIIB:	WNT	1
+			BK_C	0x90
+PP14IIIB:	WNT	1
+			BK_C	0x90
+PP15IIIB:	WNT	1
+			BK_C	0xA0
+PP16IIIB:	WNT	1
+			BK_C	0xA0
+PP17IIIB:	WNT	1
+			BK_C	0xB0
+PP18IIIB:	WNT	1
+			BK_C	0xB0
+PP19IIIB:	WNT	1
+			BK_C	0xC0
+PP20IIIB:	WNT	1
+			BK_C	0xC0
+PP21IIIB:	WNT	1
+			BK_C	0xD0
+PP22IIIB:	WNT	1
+			BK_C	0xD0
+PP23IIIB:	WNT	1
+			U_INT3
+			U_INT2
+			P_LDL	0x80
+			BR	SlotTable
 ;-------------------------------------------------------------
 
-RecvIII:		JMP		RFInit
+RecvIII:		JMP	RFInit
 			JMP	RFDKnow1
-        	BR		label_2D
-;-------------------------------------------------------------
-
-            JMP		RFInit
-            JMP		RFDKnow2
-label_2D: 	JMP		RecvPP
-            WT		1
-            B_BRFU	0x0E
-            JMP		label_6B
-            BR		label_51
-;-------------------------------------------------------------
-
-            JMP		RFInit
-            JMP		RFDKnow1
-            BR		label_37
-;-------------------------------------------------------------
-
-            JMP		RFInit
-            JMP		RFDKnow2
-label_37: 	JMP		RecvPP
-            BR		label_1
-;-------------------------------------------------------------
-
-            JMP		RFInit
-            JMP		RFDKnow1
-            BR		label_3E
-;-------------------------------------------------------------
-
-            JMP		RFInit
-            JMP		RFDKnow2
-label_3E: 	JMP		label_2
-            WT		1
-            B_BTFU	0x0E
-            JMP		label_3
-            BR		label_54
-;-------------------------------------------------------------
-
-            JMP		RFInit
-            JMP		RFDKnow2
-            JMP		label_2
-            WT		1
-            B_BT	0x0E
-            JMP		label_4
-            BR		label_53
+label_2D:	JMP	RecvPP
+			WT	1
+			B_BRFU	0x0E
+			JMP	label_6B
+			BR	label_51
 ;-------------------------------------------------------------
 
-            JMP		RFInit
-            JMP		RFDKnow1
-            BR		label_4F
-;-------------------------------------------------------------
-
-            JMP		RFInit
-            JMP		RFDKnow2
-label_4F:	JMP		label_2
-            BR		label_5
+RecvIIIB:	JMP	RFInit
+			JMP	RFDKnow1
+			JMP	RecvPPB
+			WT	1
+			B_BRFU	0x44
+			JMP	label_6B
+			B_WRS	0x36
+			WT	7
+			BR	label_53
 ;-------------------------------------------------------------
 
 label_51: 	B_WRS	0x00
@@ -114,11 +158,6 @@ label_54: 	MEN1N
 label_6: 	RTN	
 ;-------------------------------------------------------------
 
-label_7: 	B_RST	
-            MEN1N	
-            BR		label_6
-;-------------------------------------------------------------
-
 RecvPP: 	MEN2	
             P_LDL	PB_RSSI
             WT		1
@@ -137,93 +176,43 @@ RecvPP: 	MEN2
             RTN	
 ;-------------------------------------------------------------
 
-label_6B: 	WT		249
-            WT		79
-label_10: 	P_LDH	PB_RSSI
-            P_LDL	0x20|PB_RADIOPOWER|PB_DCTHRESHOLD
-            RTN	
-;-------------------------------------------------------------
-
-label_2: 	MEN2	
-            WT		2
+RecvPPB:	MEN2	
+            P_LDL	PB_RSSI
+            WT		1
             RFDIS	
-            B_RST	
-            B_RC	0x50
-            WT		8
             WNT		1
-            WT		4
-            P_LDH	PB_RX_ON
-            WT		3
-            P_LDH	PB_TX_ON
-            WT		3
-            B_ST2	
-            WT		31
-            B_AT2	0x06
-            WT		61
-            RTN	
-;-------------------------------------------------------------
-
-label_3:	WT		249
-            WT		84
-            B_RST	
-label_4: 	P_LDL	PB_TX_ON
-            WT		8
-            P_LDL	PB_RX_ON|PB_RADIOPOWER
-            RTN	
-;-------------------------------------------------------------
-
-label_8: 	B_XON	
-            WT		15
-            B_XOFF	
+            WT		5
+            B_XON	
+            WT		14
+            B_SR	
+            EN_SL_ADJ	
+            WT		13
+            P_LDH	PB_DCTHRESHOLD
+            WT		32
+            B_AR2	0x3C
             WT		61
             RTN	
 ;-------------------------------------------------------------
 
-label_9: 	WT		61
-            JMP		label_8
-            JMP		label_8
-            JMP		label_8
-            JMP		label_8
-            JMP		label_8
-            WT		1
-            B_XON	
-            WT		11
+label_6B: 	WT		249
+            WT		79
+label_10: 	P_LDH	PB_RSSI
+            P_LDL	0x20|PB_RADIOPOWER|PB_DCTHRESHOLD
             RTN	
 ;-------------------------------------------------------------
 
-label_1: 	B_BR	0x0E
-            JMP		label_9
-            WT		3
-            B_XR	
-            WT		6
-            JMP		label_10
-            B_WRS	0x00
-            WT		6
-            BR		label_7
-;-------------------------------------------------------------
-
-label_5: 	B_BT	0x0E
-            WT		3
-            JMP		label_9
-            B_XT	
-            WT		13
-            B_RST	
-            JMP		label_4
-            BR		label_7
-;-------------------------------------------------------------
-
 RFInit:	RFEN	
             WT		1
             WT		1
-            M_WR	0x4A
+            M_WR	0x6C
             WT		9
             M_RST	
             JMP		label_C0
-            M_WR	0x4B
+            M_WR	0x6D
             WT		17
             M_RST	
             JMP		label_C0
-            M_WR	0x4D
+            M_WR	0x6F
             WT		25
             M_RST	
             RTN	
@@ -233,9 +222,8 @@ RFDKnow1: 	JMP		label_C0
             BR		RFDKnow3
 ;-------------------------------------------------------------
 
-RFDKnow2: 	JMP		label_C3
 RFDKnow3: 	B_RST	
-            B_RC	0x58
+            B_RC	0x79
             WT		8
             MEN2N	
             P_LDH	PB_RADIOPOWER
@@ -248,10 +236,6 @@ label_C0: 	MEN1
       		RTN	
 ;-------------------------------------------------------------
 
-label_C3: 	MEN1	
-            RTN	
-;-------------------------------------------------------------
-
 PPSync: 	BK_C	0x20
 PPSearchIII: JMP		RFInit
             JMP		RFDKnow1
@@ -295,6 +279,7 @@ InitDIP: 	B_RST
             BR		PPSync
 ;-------------------------------------------------------------
 
-		SHARED		PP0III,PP2III,PP4III,PP6III,PP8III,PP10III,PP12III,PP14III,PP16III,PP18III,PP20III,PP22III
-		SHARED		JP0III,JP2III,JP4III,JP6III,JP8III,JP10III,JP12III,JP14III,JP16III,JP18III,JP20III,JP22III
-		SHARED		RecvNextIII,PPFoundIII,RecvIII
+		SHARED		PP0III,PP1III,PP2III,PP3III,PP4III,PP5III,PP6III,PP7III,PP8III,PP9III,PP10III,PP11III,PP12III,PP13III,PP14III,PP15III,PP16III,PP17III,PP18III,PP19III,PP20III,PP21III,PP22III,PP23III
+		SHARED		JP0III,JP1III,JP2III,JP3III,JP4III,JP5III,JP6III,JP7III,JP8III,JP9III,JP10III,JP11III,JP12III,JP13III,JP14III,JP15III,JP16III,JP17III,JP18III,JP19III,JP20III,JP21III,JP22III,JP23III
+		SHARED		PP0IIIB,PP1IIIB,PP2IIIB,PP3IIIB,PP4IIIB,PP5IIIB,PP6IIIB,PP7IIIB,PP8IIIB,PP9IIIB,PP10IIIB,PP11IIIB,PP12IIIB,PP13IIIB,PP14IIIB,PP15IIIB,PP16IIIB,PP17IIIB,PP18IIIB,PP19IIIB,PP20IIIB,PP21IIIB,PP22IIIB,PP23IIIB
+		SHARED		RecvNextIII,PPFoundIII,RecvIII,PPSearchIII,RecvIIIB
@@ -16,44 +16,122 @@ PB_RSSI			EQU		0x01
 Start:		BR	InitDIP
 ;-------------------------------------------------------------
 
+; frames alternate between SlotTable and SlotTableB. B frames receive
+; into the second buffer of each slot (0x36 on) and add U_INT2 to their
+; interrupts, so the host can read a frame until its table comes round
+; again.
+
 SlotTable:	SLOTZERO	
 JP0II:		BK_C	0x20
-PP0II:		WNT	2
+PP0II:		WNT	1
+JP1II:		BK_C	0x20
+PP1II:		WNT	1
 JP2II:		BK_C	0x30
-PP2II:		WNT	2
+PP2II:		WNT	1
+JP3II:		BK_C	0x30
+PP3II:		WNT	1
 JP4II:		BK_C	0x40
-PP4II:		WNT	2
+PP4II:		WNT	1
+JP5II:		BK_C	0x40
+PP5II:		WNT	1
 JP6II:		BK_C	0x50
-PP6II:		WNT	2
+PP6II:		WNT	1
+JP7II:		BK_C	0x50
+PP7II:		WNT	1
 JP8II:		BK_C	0x60
-PP8II:		WNT	2
+PP8II:		WNT	1
+JP9II:		BK_C	0x60
+PP9II:		WNT	1
 JP10II:		BK_C	0x70
-PP10II:		WNT	2
+PP10II:		WNT	1
+JP11II:		BK_C	0x70
+PP11II:		WNT	1
 			U_INT0
 JP12II:		BK_C	0x80
-PP12II:		WNT	2
+PP12II:		WNT	1
+JP13II:		BK_C	0x80
+PP13II:		WNT	1
 JP14II:		BK_C	0x90
-PP14II:		WNT	2
+PP14II:		WNT	1
+JP15II:		BK_C	0x90
+PP15II:		WNT	1
 JP16II:		BK_C	0xA0
-PP16II:		WNT	2
+PP16II:		WNT	1
+JP17II:		BK_C	0xA0
+PP17II:		WNT	1
 JP18II:		BK_C	0xB0
-PP18II:		WNT	2
+PP18II:		WNT	1
+JP19II:		BK_C	0xB0
+PP19II:		WNT	1
 JP20II:		BK_C	0xC0
-PP20II:		WNT	2
+PP20II:		WNT	1
+JP21II:		BK_C	0xC0
+PP21II:		WNT	1
 JP22II:		BK_C	0xD0
-PP22II:		WNT	2
+PP22II:		WNT	1
+JP23II:		BK_C	0xD0
+PP23II:		WNT	1
+			U_INT3
+			P_LDL	0x80
+SlotTableB:	SLOTZERO	
+			BK_C	0x20
+PP0IIB:		WNT	1
+			BK_C	0x20
+PP1IIB:		WNT	1
+			BK_C	0x30
+PP2IIB:		WNT	1
+			BK_C	0x30
+PP3IIB:		WNT	1
+			BK_C	0x40
+PP4IIB:		WNT	1
+			BK_C	0x40
+PP5IIB:		WNT	1
+			BK_C	0x50
+PP6IIB:		WNT	1
+			BK_C	0x50
+PP7IIB:		WNT	1
+			BK_C	0x60
+PP8IIB:		WNT	1
+			BK_C	0x60
+PP9IIB:		WNT	1
+			BK_C	0x70
+PP10IIB:	WNT	1
+			BK_C	0x70
+PP11IIB:	WNT	1
+			U_INT0
+			U_INT2
+			BK_C	0x80
+PP12IIB:	WNT	1
+			BK_C	0x80
+PP13IIB:	WNT	1
+			BK_C	0x90
+PP14IIB:	WNT	1
+			BK_C	0x90
+PP15IIB:	WNT	1
+			BK_C	0xA0
+PP16IIB:	WNT	1
+			BK_C	0xA0
+PP17IIB:	WNT	1
+			BK_C	0xB0
+PP18IIB:	WNT	1
+			BK_C	0xB0
+PP19IIB:	WNT	1
+			BK_C	0xC0
+PP20IIB:	WNT	1
+			BK_C	0xC0
+PP21IIB:	WNT	1
+			BK_C	0xD0
+PP22IIB:	WNT	1
+			BK_C	0xD0
+PP23IIB:	WNT	1
 			U_INT3
+			U_INT2
 			P_LDL	0x80
 			BR	SlotTable
 ;-------------------------------------------------------------
 
 RecvII:		JMP	RFInit
 			JMP	RFDKnow1
-			BR	label_2D
-;-------------------------------------------------------------
-
-			JMP	RFInit
-			JMP	RFDKnow2
 label_2D:	JMP	RecvPP
 			WT	1
 			B_BRFU	0x0E
@@ -61,51 +139,17 @@ label_2D:	JMP	RecvPP
 			BR	label_51
 ;-------------------------------------------------------------
 
-			JMP	RFInit
-			JMP	RFDKnow1
-			BR	label_37
-;-------------------------------------------------------------
-
-			JMP	RFInit
-			JMP	RFDKnow2
-label_37:	JMP	RecvPP
-			BR	label_1
-;-------------------------------------------------------------
-
-			JMP	RFInit
+RecvIIB:	JMP	RFInit
 			JMP	RFDKnow1
-			BR	label_3E
-;-------------------------------------------------------------
-
-			JMP	RFInit
-			JMP	RFDKnow2
-label_3E:	JMP	label_2
-			WT	1
-			B_BTFU	0x0E
-			JMP	label_3
-			BR	label_54
-;-------------------------------------------------------------
-
-			JMP	RFInit
-			JMP	RFDKnow2
-			JMP	label_2
+			JMP	RecvPPB
 			WT	1
-			B_BT	0x0E
-			JMP	label_4
+			B_BRFU	0x44
+			JMP	label_6B
+			B_WRS	0x36
+			WT	6
 			BR	label_53
 ;-------------------------------------------------------------
 
-			JMP	RFInit
-			JMP	RFDKnow1
-			BR	label_4F
-;-------------------------------------------------------------
-
-			JMP	RFInit
-			JMP	RFDKnow2
-label_4F:	JMP	label_2
-			BR	label_5
-;-------------------------------------------------------------
-
 label_51:	B_WRS	0x00
 			WT	6
 label_53:	B_RST	
@@ -115,11 +159,6 @@ label_54:	P_LDL	PB_RX_ON|PB_TX_ON
 label_6:	RTN	
 ;-------------------------------------------------------------
 
-label_7:	B_RST	
-			P_LDL	PB_RX_ON|PB_TX_ON
-			BR	label_6
-;-------------------------------------------------------------
-
 RecvPP:		P_LDH	PB_RX_ON
 			P_LDL	PB_RSSI	
 			WT	25
@@ -138,86 +177,41 @@ RecvPP:		P_LDH	PB_RX_ON
 			RTN	
 ;-------------------------------------------------------------
 
-label_6B:	WT	249
-			WT	79
-label_10:	P_LDH	PB_RSSI
-			P_LDL	PB_RX_ON
-			RTN	
-;-------------------------------------------------------------
-
-label_2:	P_LDH	0x00
-			WT	40
-			B_RST	
-			B_RC	0x50
+RecvPPB:	P_LDH	PB_RX_ON
+			P_LDL	PB_RSSI	
+			WT	25
 			WNT	1
-			B_ST	0x00
-			WT	1
-			P_LDH	PB_TX_ON
-			WT	37
-			B_AT2	0x06
+			WT	9
+			B_XON	
+			P_LDH	PB_DCTHRESHOLD
+			WT	5
+			B_SR	
+			EN_SL_ADJ	
+			WT	12
+			P_LDL	PB_DCTHRESHOLD
+			WT	33
+			B_AR2	0x3C
 			WT	61
 			RTN	
 ;-------------------------------------------------------------
 
-label_3:  	WT	249
-           	WT	84
-           	B_RST	
-label_4:  	P_LDL	PB_TX_ON
-           	WT	8
-           	P_LDL	0x00
-           	RTN	
-;-------------------------------------------------------------
-
-label_8:  	B_XON	
-            WT	15
-            B_XOFF	
-            WT	61
-            RTN	
-;-------------------------------------------------------------
-
-label_9:  	WT	61
-            JMP	label_8
-            JMP	label_8
-            JMP	label_8
-            JMP	label_8
-            JMP	label_8
-            WT	1
-            B_XON	
-            WT	11
-            RTN	
-;-------------------------------------------------------------
-
-label_1:  	B_BR	0x0E
-            JMP	label_9
-            WT	3
-            B_XR	
-            WT	6
-            JMP	label_10
-            B_WRS	0x00
-            WT	6
-            BR	label_7
-;-------------------------------------------------------------
-
-label_5:  	B_BT	0x0E
-            WT	3
-            JMP	label_9
-            B_XT	
-            WT	13
-            B_RST	
-            JMP	label_4
-            BR	label_7
+label_6B:	WT	249
+			WT	79
+label_10:	P_LDH	PB_RSSI
+			P_LDL	PB_RX_ON
+			RTN	
 ;-------------------------------------------------------------
 
 RFInit:  	RFEN	
             MEN1N	
             WT	1
             WT	1
-            M_WR	0x4A
+            M_WR	0x6C
             WT	25
             M_RST	
             MEN1	
             MEN1N	
-            M_WR	0x4D
+            M_WR	0x6F
             WT	10
             M_RST	
             MEN1	
@@ -228,12 +222,8 @@ RFDKnow1:  	P_LDL	0x20
             BR	RFDKnow3
 ;-------------------------------------------------------------
 
-RFDKnow2:  	P_LDH	0x20
-            BR	RFDKnow3
-;-------------------------------------------------------------
-
 RFDKnow3:	B_RST	
-			B_RC	0x58
+			B_RC	0x79
 			WT	8
 			MEN2	
 			WT	118
@@ -286,6 +276,7 @@ InitDIP:	B_RST
 			BR	PPSync
 ;-------------------------------------------------------------
 
-		SHARED		PP0II,PP2II,PP4II,PP6II,PP8II,PP10II,PP12II,PP14II,PP16II,PP18II,PP20II,PP22II
-		SHARED		JP0II,JP2II,JP4II,JP6II,JP8II,JP10II,JP12II,JP14II,JP16II,JP18II,JP20II,JP22II
-		SHARED		RecvNextII,PPFoundII,RecvII
+		SHARED		PP0II,PP1II,PP2II,PP3II,PP4II,PP5II,PP6II,PP7II,PP8II,PP9II,PP10II,PP11II,PP12II,PP13II,PP14II,PP15II,PP16II,PP17II,PP18II,PP19II,PP20II,PP21II,PP22II,PP23II
+		SHARED		JP0II,JP1II,JP2II,JP3II,JP4II,JP5II,JP6II,JP7II,JP8II,JP9II,JP10II,JP11II,JP12II,JP13II,JP14II,JP15II,JP16II,JP17II,JP18II,JP19II,JP20II,JP21II,JP22II,JP23II
+		SHARED		PP0IIB,PP1IIB,PP2IIB,PP3IIB,PP4IIB,PP5IIB,PP6IIB,PP7IIB,PP8IIB,PP9IIB,PP10IIB,PP11IIB,PP12IIB,PP13IIB,PP14IIB,PP15IIB,PP16IIB,PP17IIB,PP18IIB,PP19IIB,PP20IIB,PP21IIB,PP22IIB,PP23IIB
+		SHARED		RecvNextII,PPFoundII,RecvII,PPSearchII,RecvIIB
@@ -18,24 +18,27 @@
 
 #include "sc14421.h"
 #include "dip_opcodes.h"
+#include "com_on_air.h"
 
-static u_int deviceConfigBase = 0;
+#ifndef lockdep_assert_held /* not before 2.6.32 */
+#define lockdep_assert_held(l)	do { (void)(l); } while (0)
+#endif
 
-void set_device_configbase(u_int configBase)
+void set_device_configbase(struct coa_info *dev, u_int configBase)
 {
-	deviceConfigBase = configBase;
+	dev->config_base = configBase;
 }
 
-void wait_4_IO_cycles()
+void wait_4_IO_cycles(struct coa_info *dev)
 {
-	if (!deviceConfigBase) {
+	if (!dev->config_base) {
 		printk("error: config base not set!\n");
 		return;
 	}
-	inb_p(deviceConfigBase);
-	inb_p(deviceConfigBase);
-	inb_p(deviceConfigBase);
-	inb_p(deviceConfigBase);
+	inb_p(dev->config_base);
+	inb_p(dev->config_base);
+	inb_p(dev->config_base);
+	inb_p(dev->config_base);
 }
 
 void to_dip(volatile uint16_t *dst, unsigned char *src, int length)
@@ -64,15 +67,57 @@ void from_dip(unsigned char *dst, volatile uint16_t *src, int length)
 #endif
 }
 
-void SC14421_switch_to_bank(volatile uint16_t *sc14421_base, unsigned char bank)
+/* one memcpy_fromio() of length words into words[], the bridge can burst
+ * that instead of taking a volatile read per word */
+void from_dip_burst(uint16_t *words, volatile uint16_t *src, int length)
+{
+	memcpy_fromio(words, (void __iomem *) src, length * 2);
+}
+
+/* the low bytes of a from_dip_burst() snapshot. the words are still in
+ * the card's little endian byte order, so the low byte comes first */
+void from_dip_pack(unsigned char *dst, const uint16_t *words, int length)
 {
+	const unsigned char *b = (const unsigned char *) words;
+	int i;
+
+	for (i=0; i<length; i++)
+		dst[i] = b[2*i];
+}
+
+/* the DIP never changes the bank register on its own, so we can skip
+ * switching to the bank that is already selected. dev->bank is only
+ * right as long as every switch holds dip_lock. */
+void SC14421_switch_to_bank(struct coa_info *dev, unsigned char bank)
+{
+	volatile uint16_t *sc14421_base = dev->sc14421_base;
+
+	lockdep_assert_held(&dev->dip_lock);
+
+	if (bank == dev->bank)
+	{
+		dev->stats.bank_elided++;
+		return;
+	}
+
+#ifdef COA_SIMULATE
+	sc14421_sim_switch_to_bank(sc14421_base, bank);
+#else
 	SC14421_WRITE(511, bank);
-	wait_4_IO_cycles();
+	wait_4_IO_cycles(dev);
+#endif
+
+	dev->bank = bank;
+	dev->stats.bank_switches++;
 }
 
-void SC14421_stop_dip(volatile uint16_t *sc14421_base)
+void SC14421_stop_dip(struct coa_info *dev)
 {
-	SC14421_switch_to_bank(sc14421_base, SC14421_DIPSTOPPED);
+	unsigned long flags;
+
+	spin_lock_irqsave(&dev->dip_lock, flags);
+	SC14421_switch_to_bank(dev, SC14421_DIPSTOPPED);
+	spin_unlock_irqrestore(&dev->dip_lock, flags);
 }
 
 void SC14421_write_cmd(volatile uint16_t *sc14421_base, int label, unsigned char opcode, unsigned char operand)
@@ -85,6 +130,10 @@ uint8_t SC14421_clear_interrupt(volatile uint16_t *sc14421_base)
 {
         unsigned char int1, int2, cnt = 0;
 
+#ifdef COA_SIMULATE
+	return sc14421_sim_clear_interrupt(sc14421_base);
+#endif
+
         int1 = SC14421_READ(511);
 
 	/* is the card still plugged */
@@ -108,8 +157,9 @@ uint8_t SC14421_clear_interrupt(volatile uint16_t *sc14421_base)
 
 
 
-int SC14421_check_RAM(volatile uint16_t *sc14421_base)
+int SC14421_check_RAM(struct coa_info *dev)
 {
+	volatile uint16_t *sc14421_base = dev->sc14421_base;
 	unsigned char bank;
 	int ErrCnt;
 	int i;
@@ -120,7 +170,7 @@ int SC14421_check_RAM(volatile uint16_t *sc14421_base)
 	for (i=0; i<8; i++)
 	{
 		bank = (4*i) | 0x80;
-		SC14421_switch_to_bank(sc14421_base, bank);
+		SC14421_switch_to_bank(dev, bank);
 
 		for (x=0; x<254; x++)
 			SC14421_WRITE(x, (x+i) & 0xff);
@@ -129,7 +179,7 @@ int SC14421_check_RAM(volatile uint16_t *sc14421_base)
 	for (i=0; i<8; i++)
 	{
 		bank = (4*i)|0x80;
-		SC14421_switch_to_bank(sc14421_base, bank);
+		SC14421_switch_to_bank(dev, bank);
 		
 		for (x=0; x<254; x++)
 		{
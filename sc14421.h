@@ -27,6 +27,9 @@
 #define SC14421_RAMBANK7        0x1c
 #define SC14421_CODEBANK        0x20
 
+/* dev->bank before the first switch */
+#define SC14421_BANK_UNKNOWN    0xff
+
 #if defined(__LITTLE_ENDIAN)
 # define SC14421_READ(offset)		sc14421_base[(offset)]
 # define SC14421_WRITE(offset, value)	{ sc14421_base[(offset)] = (value); }
@@ -37,14 +40,25 @@
 # error "could not determine endianness"
 #endif
 
-void set_device_configbase(u_int);
-void wait_4_IO_cycles(void);
+struct coa_info;
+
+void set_device_configbase(struct coa_info *dev, u_int configBase);
+void wait_4_IO_cycles(struct coa_info *dev);
 void to_dip(volatile unsigned short *dst, unsigned char *src, int length);
 void from_dip(unsigned char *dst, volatile uint16_t *src, int length);
-void SC14421_switch_to_bank(volatile uint16_t *sc14421_base, unsigned char bank);
-void SC14421_stop_dip(volatile uint16_t *sc14421_base);
+void from_dip_burst(uint16_t *words, volatile uint16_t *src, int length);
+void from_dip_pack(unsigned char *dst, const uint16_t *words, int length);
+void SC14421_switch_to_bank(struct coa_info *dev, unsigned char bank);
+void SC14421_stop_dip(struct coa_info *dev);
 void SC14421_write_cmd(volatile uint16_t *sc14421_base, int label, unsigned char opcode, unsigned char operand);
 unsigned char SC14421_clear_interrupt(volatile uint16_t *sc14421_base);
-int SC14421_check_RAM(volatile uint16_t *sc14421_base);
+int SC14421_check_RAM(struct coa_info *dev);
+
+#ifdef COA_SIMULATE
+/* software SC14421, see tools/coa_sim. the DIP memory window is a plain
+ * array, only the bank and interrupt registers need help. */
+void sc14421_sim_switch_to_bank(volatile uint16_t *sc14421_base, unsigned char bank);
+uint8_t sc14421_sim_clear_interrupt(volatile uint16_t *sc14421_base);
+#endif
 
 #endif
@@ -76,64 +76,64 @@ unsigned char sc14421_II_sniff_scan_fw[] = {
  * edit firmware/filename.asm instead */
 
 unsigned char sc14421_II_sniff_sync_fw[] = {
-	0x01, 0x01, 0x01, 0xcc, 0x0d, 0x00, 0x0f, 0x20,
-	0x08, 0x02, 0x0f, 0x30, 0x08, 0x02, 0x0f, 0x40,
-	0x08, 0x02, 0x0f, 0x50, 0x08, 0x02, 0x0f, 0x60,
-	0x08, 0x02, 0x0f, 0x70, 0x08, 0x02, 0x61, 0x00,
-	0x0f, 0x80, 0x08, 0x02, 0x0f, 0x90, 0x08, 0x02,
-	0x0f, 0xa0, 0x08, 0x02, 0x0f, 0xb0, 0x08, 0x02,
-	0x0f, 0xc0, 0x08, 0x02, 0x0f, 0xd0, 0x08, 0x02,
-	0x6f, 0x00, 0xec, 0x80, 0x01, 0x02, 0x02, 0x9a,
-	0x02, 0xa8, 0x01, 0x24, 0x02, 0x9a, 0x02, 0xaa,
-	0x02, 0x52, 0x09, 0x01, 0x2d, 0x0e, 0x02, 0x62,
-	0x01, 0x48, 0x02, 0x9a, 0x02, 0xa8, 0x01, 0x2e,
-	0x02, 0x9a, 0x02, 0xaa, 0x02, 0x52, 0x01, 0x89,
-	0x02, 0x9a, 0x02, 0xa8, 0x01, 0x35, 0x02, 0x9a,
-	0x02, 0xaa, 0x02, 0x67, 0x09, 0x01, 0x25, 0x0e,
-	0x02, 0x73, 0x01, 0x4b, 0x02, 0x9a, 0x02, 0xaa,
-	0x02, 0x67, 0x09, 0x01, 0x34, 0x0e, 0x02, 0x76,
-	0x01, 0x4a, 0x02, 0x9a, 0x02, 0xa8, 0x01, 0x46,
-	0x02, 0x9a, 0x02, 0xaa, 0x02, 0x67, 0x01, 0x92,
-	0x39, 0x00, 0x09, 0x06, 0x20, 0x00, 0xec, 0x50,
-	0x09, 0x05, 0x08, 0x01, 0x04, 0x00, 0x20, 0x00,
-	0xec, 0x50, 0x01, 0x4e, 0xed, 0x40, 0xec, 0x01,
-	0x09, 0x19, 0x08, 0x01, 0x09, 0x09, 0x27, 0x00,
-	0xed, 0x02, 0x09, 0x05, 0x29, 0x00, 0x2c, 0x00,
-	0x09, 0x0c, 0xec, 0x02, 0x09, 0x21, 0x3f, 0x06,
-	0x09, 0x3d, 0x04, 0x00, 0x09, 0xf9, 0x09, 0x4f,
-	0xed, 0x01, 0xec, 0x40, 0x04, 0x00, 0xed, 0x00,
-	0x09, 0x28, 0x20, 0x00, 0x33, 0x50, 0x08, 0x01,
-	0x31, 0x00, 0x09, 0x01, 0xed, 0x10, 0x09, 0x25,
-	0x37, 0x06, 0x09, 0x3d, 0x04, 0x00, 0x09, 0xf9,
-	0x09, 0x54, 0x20, 0x00, 0xec, 0x10, 0x09, 0x08,
-	0xec, 0x00, 0x04, 0x00, 0x27, 0x00, 0x09, 0x0f,
-	0x26, 0x00, 0x09, 0x3d, 0x04, 0x00, 0x09, 0x3d,
-	0x02, 0x7a, 0x02, 0x7a, 0x02, 0x7a, 0x02, 0x7a,
-	0x02, 0x7a, 0x09, 0x01, 0x27, 0x00, 0x09, 0x0b,
-	0x04, 0x00, 0x3c, 0x0e, 0x02, 0x7f, 0x09, 0x03,
-	0x2b, 0x00, 0x09, 0x06, 0x02, 0x64, 0x39, 0x00,
-	0x09, 0x06, 0x01, 0x4f, 0x34, 0x0e, 0x09, 0x03,
-	0x02, 0x7f, 0x24, 0x00, 0x09, 0x0d, 0x20, 0x00,
-	0x02, 0x76, 0x01, 0x4f, 0x0b, 0x00, 0xa4, 0x00,
-	0x09, 0x01, 0x09, 0x01, 0xb9, 0x4a, 0x09, 0x19,
-	0xa9, 0x00, 0xa5, 0x00, 0xa4, 0x00, 0xb9, 0x4d,
-	0x09, 0x0a, 0xa9, 0x00, 0xa5, 0x00, 0x04, 0x00,
-	0xec, 0x20, 0x01, 0xac, 0xed, 0x20, 0x01, 0xac,
-	0x20, 0x00, 0x33, 0x58, 0x09, 0x08, 0xa7, 0x00,
-	0x09, 0x76, 0x09, 0x40, 0xa6, 0x00, 0xed, 0x00,
-	0x09, 0x10, 0x04, 0x00, 0x0f, 0x20, 0x02, 0x9a,
-	0x02, 0xa8, 0x09, 0xfa, 0xea, 0x20, 0xed, 0x42,
-	0x28, 0x00, 0x09, 0x40, 0x26, 0x00, 0x29, 0x00,
-	0x08, 0x14, 0x03, 0xc6, 0x20, 0x00, 0x6b, 0x00,
-	0x08, 0x17, 0x01, 0xb7, 0x08, 0x17, 0xea, 0x00,
-	0x02, 0x1f, 0x61, 0x00, 0x08, 0x16, 0x01, 0xb7,
-	0x20, 0x00, 0x0f, 0x00, 0xfa, 0x10, 0x09, 0x0a,
-	0x33, 0x00, 0x09, 0x08, 0x20, 0x00, 0xee, 0x00,
-	0x09, 0x0a, 0xe9, 0x00, 0xe8, 0x04, 0x62, 0x00,
-	0x0b, 0x00, 0x01, 0xb6, 0xff, 0xff, 0xff, 0xff,
-	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0x01, 0x01, 0x01, 0xd9, 0x0d, 0x00, 0x0f, 0x20,
+	0x08, 0x01, 0x0f, 0x20, 0x08, 0x01, 0x0f, 0x30,
+	0x08, 0x01, 0x0f, 0x30, 0x08, 0x01, 0x0f, 0x40,
+	0x08, 0x01, 0x0f, 0x40, 0x08, 0x01, 0x0f, 0x50,
+	0x08, 0x01, 0x0f, 0x50, 0x08, 0x01, 0x0f, 0x60,
+	0x08, 0x01, 0x0f, 0x60, 0x08, 0x01, 0x0f, 0x70,
+	0x08, 0x01, 0x0f, 0x70, 0x08, 0x01, 0x61, 0x00,
+	0x0f, 0x80, 0x08, 0x01, 0x0f, 0x80, 0x08, 0x01,
+	0x0f, 0x90, 0x08, 0x01, 0x0f, 0x90, 0x08, 0x01,
+	0x0f, 0xa0, 0x08, 0x01, 0x0f, 0xa0, 0x08, 0x01,
+	0x0f, 0xb0, 0x08, 0x01, 0x0f, 0xb0, 0x08, 0x01,
+	0x0f, 0xc0, 0x08, 0x01, 0x0f, 0xc0, 0x08, 0x01,
+	0x0f, 0xd0, 0x08, 0x01, 0x0f, 0xd0, 0x08, 0x01,
+	0x6f, 0x00, 0xec, 0x80, 0x0d, 0x00, 0x0f, 0x20,
+	0x08, 0x01, 0x0f, 0x20, 0x08, 0x01, 0x0f, 0x30,
+	0x08, 0x01, 0x0f, 0x30, 0x08, 0x01, 0x0f, 0x40,
+	0x08, 0x01, 0x0f, 0x40, 0x08, 0x01, 0x0f, 0x50,
+	0x08, 0x01, 0x0f, 0x50, 0x08, 0x01, 0x0f, 0x60,
+	0x08, 0x01, 0x0f, 0x60, 0x08, 0x01, 0x0f, 0x70,
+	0x08, 0x01, 0x0f, 0x70, 0x08, 0x01, 0x61, 0x00,
+	0x6d, 0x00, 0x0f, 0x80, 0x08, 0x01, 0x0f, 0x80,
+	0x08, 0x01, 0x0f, 0x90, 0x08, 0x01, 0x0f, 0x90,
+	0x08, 0x01, 0x0f, 0xa0, 0x08, 0x01, 0x0f, 0xa0,
+	0x08, 0x01, 0x0f, 0xb0, 0x08, 0x01, 0x0f, 0xb0,
+	0x08, 0x01, 0x0f, 0xc0, 0x08, 0x01, 0x0f, 0xc0,
+	0x08, 0x01, 0x0f, 0xd0, 0x08, 0x01, 0x0f, 0xd0,
+	0x08, 0x01, 0x6f, 0x00, 0x6d, 0x00, 0xec, 0x80,
+	0x01, 0x02, 0x02, 0xa9, 0x02, 0xb7, 0x02, 0x84,
+	0x09, 0x01, 0x2d, 0x0e, 0x02, 0xa4, 0x01, 0x7d,
+	0x02, 0xa9, 0x02, 0xb7, 0x02, 0x94, 0x09, 0x01,
+	0x2d, 0x44, 0x02, 0xa4, 0x39, 0x36, 0x09, 0x06,
+	0x01, 0x7f, 0x39, 0x00, 0x09, 0x06, 0x20, 0x00,
+	0xec, 0x50, 0x09, 0x05, 0x08, 0x01, 0x04, 0x00,
+	0xed, 0x40, 0xec, 0x01, 0x09, 0x19, 0x08, 0x01,
+	0x09, 0x09, 0x27, 0x00, 0xed, 0x02, 0x09, 0x05,
+	0x29, 0x00, 0x2c, 0x00, 0x09, 0x0c, 0xec, 0x02,
+	0x09, 0x21, 0x3f, 0x06, 0x09, 0x3d, 0x04, 0x00,
+	0xed, 0x40, 0xec, 0x01, 0x09, 0x19, 0x08, 0x01,
+	0x09, 0x09, 0x27, 0x00, 0xed, 0x02, 0x09, 0x05,
+	0x29, 0x00, 0x2c, 0x00, 0x09, 0x0c, 0xec, 0x02,
+	0x09, 0x21, 0x3f, 0x3c, 0x09, 0x3d, 0x04, 0x00,
+	0x09, 0xf9, 0x09, 0x4f, 0xed, 0x01, 0xec, 0x40,
+	0x04, 0x00, 0x0b, 0x00, 0xa4, 0x00, 0x09, 0x01,
+	0x09, 0x01, 0xb9, 0x6c, 0x09, 0x19, 0xa9, 0x00,
+	0xa5, 0x00, 0xa4, 0x00, 0xb9, 0x6f, 0x09, 0x0a,
+	0xa9, 0x00, 0xa5, 0x00, 0x04, 0x00, 0xec, 0x20,
+	0x01, 0xb9, 0x20, 0x00, 0x33, 0x79, 0x09, 0x08,
+	0xa7, 0x00, 0x09, 0x76, 0x09, 0x40, 0xa6, 0x00,
+	0xed, 0x00, 0x09, 0x10, 0x04, 0x00, 0x0f, 0x20,
+	0x02, 0xa9, 0x02, 0xb7, 0x09, 0xfa, 0xea, 0x20,
+	0xed, 0x42, 0x28, 0x00, 0x09, 0x40, 0x26, 0x00,
+	0x29, 0x00, 0x08, 0x14, 0x03, 0xd3, 0x20, 0x00,
+	0x6b, 0x00, 0x08, 0x17, 0x01, 0xc4, 0x08, 0x17,
+	0xea, 0x00, 0x02, 0x6d, 0x61, 0x00, 0x08, 0x16,
+	0x01, 0xc4, 0x20, 0x00, 0x0f, 0x00, 0xfa, 0x10,
+	0x09, 0x0a, 0x33, 0x00, 0x09, 0x08, 0x20, 0x00,
+	0xee, 0x00, 0x09, 0x0a, 0xe9, 0x00, 0xe8, 0x04,
+	0x62, 0x00, 0x0b, 0x00, 0x01, 0xc3, 0xff, 0xff,
 	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
 	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
 	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
@@ -218,64 +218,64 @@ unsigned char sc14421_III_sniff_scan_fw[] = {
  * edit firmware/filename.asm instead */
 
 unsigned char sc14421_III_sniff_sync_fw[] = {
-	0x01, 0x01, 0x01, 0xd3, 0x0d, 0x00, 0x0f, 0x20,
-	0x08, 0x02, 0x0f, 0x30, 0x08, 0x02, 0x0f, 0x40,
-	0x08, 0x02, 0x0f, 0x50, 0x08, 0x02, 0x0f, 0x60,
-	0x08, 0x02, 0x0f, 0x70, 0x08, 0x02, 0x61, 0x00,
-	0x0f, 0x80, 0x08, 0x02, 0x0f, 0x90, 0x08, 0x02,
-	0x0f, 0xa0, 0x08, 0x02, 0x0f, 0xb0, 0x08, 0x02,
-	0x0f, 0xc0, 0x08, 0x02, 0x0f, 0xd0, 0x08, 0x02,
-	0x6f, 0x00, 0xec, 0x80, 0x01, 0x02, 0x02, 0x9e,
-	0x02, 0xad, 0x01, 0x24, 0x02, 0x9e, 0x02, 0xaf,
-	0x02, 0x51, 0x09, 0x01, 0x2d, 0x0e, 0x02, 0x61,
-	0x01, 0x48, 0x02, 0x9e, 0x02, 0xad, 0x01, 0x2e,
-	0x02, 0x9e, 0x02, 0xaf, 0x02, 0x51, 0x01, 0x8d,
-	0x02, 0x9e, 0x02, 0xad, 0x01, 0x35, 0x02, 0x9e,
-	0x02, 0xaf, 0x02, 0x66, 0x09, 0x01, 0x25, 0x0e,
-	0x02, 0x77, 0x01, 0x4b, 0x02, 0x9e, 0x02, 0xaf,
-	0x02, 0x66, 0x09, 0x01, 0x34, 0x0e, 0x02, 0x7a,
-	0x01, 0x4a, 0x02, 0x9e, 0x02, 0xad, 0x01, 0x46,
-	0x02, 0x9e, 0x02, 0xaf, 0x02, 0x66, 0x01, 0x96,
-	0x39, 0x00, 0x09, 0x07, 0x20, 0x00, 0xa4, 0x00,
-	0x08, 0x01, 0x04, 0x00, 0x20, 0x00, 0xa4, 0x00,
-	0x01, 0x4d, 0xa7, 0x00, 0xec, 0x01, 0x09, 0x01,
-	0x0a, 0x00, 0x08, 0x01, 0x09, 0x05, 0x27, 0x00,
-	0x09, 0x0e, 0x29, 0x00, 0x2c, 0x00, 0x09, 0x0d,
-	0xed, 0x02, 0x09, 0x20, 0x3f, 0x06, 0x09, 0x3d,
-	0x04, 0x00, 0x09, 0xf9, 0x09, 0x4f, 0xed, 0x01,
-	0xec, 0x26, 0x04, 0x00, 0xa7, 0x00, 0x09, 0x02,
-	0x0a, 0x00, 0x20, 0x00, 0x33, 0x50, 0x09, 0x08,
-	0x08, 0x01, 0x09, 0x04, 0xed, 0x40, 0x09, 0x03,
-	0xed, 0x10, 0x09, 0x03, 0x21, 0x00, 0x09, 0x1f,
-	0x37, 0x06, 0x09, 0x3d, 0x04, 0x00, 0x09, 0xf9,
-	0x09, 0x54, 0x20, 0x00, 0xec, 0x10, 0x09, 0x08,
-	0xec, 0x44, 0x04, 0x00, 0x27, 0x00, 0x09, 0x0f,
-	0x26, 0x00, 0x09, 0x3d, 0x04, 0x00, 0x09, 0x3d,
-	0x02, 0x7e, 0x02, 0x7e, 0x02, 0x7e, 0x02, 0x7e,
-	0x02, 0x7e, 0x09, 0x01, 0x27, 0x00, 0x09, 0x0b,
-	0x04, 0x00, 0x3c, 0x0e, 0x02, 0x83, 0x09, 0x03,
-	0x2b, 0x00, 0x09, 0x06, 0x02, 0x63, 0x39, 0x00,
-	0x09, 0x06, 0x01, 0x4e, 0x34, 0x0e, 0x09, 0x03,
-	0x02, 0x83, 0x24, 0x00, 0x09, 0x0d, 0x20, 0x00,
-	0x02, 0x7a, 0x01, 0x4e, 0x0b, 0x00, 0x09, 0x01,
-	0x09, 0x01, 0xb9, 0x4a, 0x09, 0x09, 0xa9, 0x00,
-	0x02, 0xb7, 0xb9, 0x4b, 0x09, 0x11, 0xa9, 0x00,
-	0x02, 0xb7, 0xb9, 0x4d, 0x09, 0x19, 0xa9, 0x00,
-	0x04, 0x00, 0x02, 0xb7, 0x01, 0xb0, 0x02, 0xba,
-	0x20, 0x00, 0x33, 0x58, 0x09, 0x08, 0xa6, 0x00,
-	0xed, 0x04, 0x09, 0xd0, 0x04, 0x00, 0xa5, 0x00,
-	0xa4, 0x00, 0x04, 0x00, 0xa5, 0x00, 0x04, 0x00,
-	0x0f, 0x20, 0x02, 0x9e, 0x02, 0xad, 0xa6, 0x00,
-	0x09, 0xfa, 0xea, 0x60, 0xed, 0x02, 0x28, 0x00,
-	0x09, 0x40, 0x26, 0x00, 0x29, 0x00, 0x08, 0x14,
-	0x03, 0xcd, 0x20, 0x00, 0x6b, 0x00, 0x08, 0x17,
-	0x01, 0xbd, 0x08, 0x17, 0xea, 0x00, 0x02, 0x1f,
-	0x61, 0x00, 0x08, 0x16, 0x01, 0xbd, 0x20, 0x00,
-	0x0f, 0x00, 0xfa, 0x10, 0x09, 0x0a, 0x33, 0x00,
-	0x09, 0x08, 0x20, 0x00, 0xee, 0x00, 0x09, 0x0a,
-	0xe9, 0x00, 0xe8, 0x00, 0x62, 0x00, 0x0b, 0x00,
-	0x01, 0xbc, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0x01, 0x01, 0x01, 0xda, 0x0d, 0x00, 0x0f, 0x20,
+	0x08, 0x01, 0x0f, 0x20, 0x08, 0x01, 0x0f, 0x30,
+	0x08, 0x01, 0x0f, 0x30, 0x08, 0x01, 0x0f, 0x40,
+	0x08, 0x01, 0x0f, 0x40, 0x08, 0x01, 0x0f, 0x50,
+	0x08, 0x01, 0x0f, 0x50, 0x08, 0x01, 0x0f, 0x60,
+	0x08, 0x01, 0x0f, 0x60, 0x08, 0x01, 0x0f, 0x70,
+	0x08, 0x01, 0x0f, 0x70, 0x08, 0x01, 0x61, 0x00,
+	0x0f, 0x80, 0x08, 0x01, 0x0f, 0x80, 0x08, 0x01,
+	0x0f, 0x90, 0x08, 0x01, 0x0f, 0x90, 0x08, 0x01,
+	0x0f, 0xa0, 0x08, 0x01, 0x0f, 0xa0, 0x08, 0x01,
+	0x0f, 0xb0, 0x08, 0x01, 0x0f, 0xb0, 0x08, 0x01,
+	0x0f, 0xc0, 0x08, 0x01, 0x0f, 0xc0, 0x08, 0x01,
+	0x0f, 0xd0, 0x08, 0x01, 0x0f, 0xd0, 0x08, 0x01,
+	0x6f, 0x00, 0xec, 0x80, 0x0d, 0x00, 0x0f, 0x20,
+	0x08, 0x01, 0x0f, 0x20, 0x08, 0x01, 0x0f, 0x30,
+	0x08, 0x01, 0x0f, 0x30, 0x08, 0x01, 0x0f, 0x40,
+	0x08, 0x01, 0x0f, 0x40, 0x08, 0x01, 0x0f, 0x50,
+	0x08, 0x01, 0x0f, 0x50, 0x08, 0x01, 0x0f, 0x60,
+	0x08, 0x01, 0x0f, 0x60, 0x08, 0x01, 0x0f, 0x70,
+	0x08, 0x01, 0x0f, 0x70, 0x08, 0x01, 0x61, 0x00,
+	0x6d, 0x00, 0x0f, 0x80, 0x08, 0x01, 0x0f, 0x80,
+	0x08, 0x01, 0x0f, 0x90, 0x08, 0x01, 0x0f, 0x90,
+	0x08, 0x01, 0x0f, 0xa0, 0x08, 0x01, 0x0f, 0xa0,
+	0x08, 0x01, 0x0f, 0xb0, 0x08, 0x01, 0x0f, 0xb0,
+	0x08, 0x01, 0x0f, 0xc0, 0x08, 0x01, 0x0f, 0xc0,
+	0x08, 0x01, 0x0f, 0xd0, 0x08, 0x01, 0x0f, 0xd0,
+	0x08, 0x01, 0x6f, 0x00, 0x6d, 0x00, 0xec, 0x80,
+	0x01, 0x02, 0x02, 0xa8, 0x02, 0xb7, 0x02, 0x83,
+	0x09, 0x01, 0x2d, 0x0e, 0x02, 0xa3, 0x01, 0x7d,
+	0x02, 0xa8, 0x02, 0xb7, 0x02, 0x93, 0x09, 0x01,
+	0x2d, 0x44, 0x02, 0xa3, 0x39, 0x36, 0x09, 0x07,
+	0x01, 0x7f, 0x39, 0x00, 0x09, 0x07, 0x20, 0x00,
+	0xa4, 0x00, 0x08, 0x01, 0x04, 0x00, 0xa7, 0x00,
+	0xec, 0x01, 0x09, 0x01, 0x0a, 0x00, 0x08, 0x01,
+	0x09, 0x05, 0x27, 0x00, 0x09, 0x0e, 0x29, 0x00,
+	0x2c, 0x00, 0x09, 0x0d, 0xed, 0x02, 0x09, 0x20,
+	0x3f, 0x06, 0x09, 0x3d, 0x04, 0x00, 0xa7, 0x00,
+	0xec, 0x01, 0x09, 0x01, 0x0a, 0x00, 0x08, 0x01,
+	0x09, 0x05, 0x27, 0x00, 0x09, 0x0e, 0x29, 0x00,
+	0x2c, 0x00, 0x09, 0x0d, 0xed, 0x02, 0x09, 0x20,
+	0x3f, 0x3c, 0x09, 0x3d, 0x04, 0x00, 0x09, 0xf9,
+	0x09, 0x4f, 0xed, 0x01, 0xec, 0x26, 0x04, 0x00,
+	0x0b, 0x00, 0x09, 0x01, 0x09, 0x01, 0xb9, 0x6c,
+	0x09, 0x09, 0xa9, 0x00, 0x02, 0xc0, 0xb9, 0x6d,
+	0x09, 0x11, 0xa9, 0x00, 0x02, 0xc0, 0xb9, 0x6f,
+	0x09, 0x19, 0xa9, 0x00, 0x04, 0x00, 0x02, 0xc0,
+	0x01, 0xb9, 0x20, 0x00, 0x33, 0x79, 0x09, 0x08,
+	0xa6, 0x00, 0xed, 0x04, 0x09, 0xd0, 0x04, 0x00,
+	0xa5, 0x00, 0xa4, 0x00, 0x04, 0x00, 0x0f, 0x20,
+	0x02, 0xa8, 0x02, 0xb7, 0xa6, 0x00, 0x09, 0xfa,
+	0xea, 0x60, 0xed, 0x02, 0x28, 0x00, 0x09, 0x40,
+	0x26, 0x00, 0x29, 0x00, 0x08, 0x14, 0x03, 0xd4,
+	0x20, 0x00, 0x6b, 0x00, 0x08, 0x17, 0x01, 0xc4,
+	0x08, 0x17, 0xea, 0x00, 0x02, 0x6d, 0x61, 0x00,
+	0x08, 0x16, 0x01, 0xc4, 0x20, 0x00, 0x0f, 0x00,
+	0xfa, 0x10, 0x09, 0x0a, 0x33, 0x00, 0x09, 0x08,
+	0x20, 0x00, 0xee, 0x00, 0x09, 0x0a, 0xe9, 0x00,
+	0xe8, 0x00, 0x62, 0x00, 0x0b, 0x00, 0x01, 0xc3,
 	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
 	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
 	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
@@ -7,65 +7,215 @@ extern unsigned char sc14421_II_sniff_scan_fw[509];
 extern unsigned char sc14421_II_sniff_sync_fw[509];
 /* sc14421_II_sniff_sync.asm-Includefile fr C-Programm */
 #define PP0II 0x4
-#define PP2II 0x6
-#define PP4II 0x8
-#define PP6II 0xA
-#define PP8II 0xC
-#define PP10II 0xE
-#define PP12II 0x11
-#define PP14II 0x13
-#define PP16II 0x15
-#define PP18II 0x17
-#define PP20II 0x19
-#define PP22II 0x1B
+#define PP1II 0x6
+#define PP2II 0x8
+#define PP3II 0xA
+#define PP4II 0xC
+#define PP5II 0xE
+#define PP6II 0x10
+#define PP7II 0x12
+#define PP8II 0x14
+#define PP9II 0x16
+#define PP10II 0x18
+#define PP11II 0x1A
+#define PP12II 0x1D
+#define PP13II 0x1F
+#define PP14II 0x21
+#define PP15II 0x23
+#define PP16II 0x25
+#define PP17II 0x27
+#define PP18II 0x29
+#define PP19II 0x2B
+#define PP20II 0x2D
+#define PP21II 0x2F
+#define PP22II 0x31
+#define PP23II 0x33
 #define JP0II 0x3
-#define JP2II 0x5
-#define JP4II 0x7
-#define JP6II 0x9
-#define JP8II 0xB
-#define JP10II 0xD
-#define JP12II 0x10
-#define JP14II 0x12
-#define JP16II 0x14
-#define JP18II 0x16
-#define JP20II 0x18
-#define JP22II 0x1A
-#define RecvNextII 0xC8
-#define PPFoundII 0xCB
-#define RecvII 0x1F
+#define JP1II 0x5
+#define JP2II 0x7
+#define JP3II 0x9
+#define JP4II 0xB
+#define JP5II 0xD
+#define JP6II 0xF
+#define JP7II 0x11
+#define JP8II 0x13
+#define JP9II 0x15
+#define JP10II 0x17
+#define JP11II 0x19
+#define JP12II 0x1C
+#define JP13II 0x1E
+#define JP14II 0x20
+#define JP15II 0x22
+#define JP16II 0x24
+#define JP17II 0x26
+#define JP18II 0x28
+#define JP19II 0x2A
+#define JP20II 0x2C
+#define JP21II 0x2E
+#define JP22II 0x30
+#define JP23II 0x32
+#define PP0IIB 0x38
+#define PP1IIB 0x3A
+#define PP2IIB 0x3C
+#define PP3IIB 0x3E
+#define PP4IIB 0x40
+#define PP5IIB 0x42
+#define PP6IIB 0x44
+#define PP7IIB 0x46
+#define PP8IIB 0x48
+#define PP9IIB 0x4A
+#define PP10IIB 0x4C
+#define PP11IIB 0x4E
+#define PP12IIB 0x52
+#define PP13IIB 0x54
+#define PP14IIB 0x56
+#define PP15IIB 0x58
+#define PP16IIB 0x5A
+#define PP17IIB 0x5C
+#define PP18IIB 0x5E
+#define PP19IIB 0x60
+#define PP20IIB 0x62
+#define PP21IIB 0x64
+#define PP22IIB 0x66
+#define PP23IIB 0x68
+#define RecvNextII 0xD5
+#define PPFoundII 0xD8
+#define RecvII 0x6D
+#define PPSearchII 0xC4
+#define RecvIIB 0x74
 /* Ende Includefile fr C-Programm */
+
+/* automatically generated file
+ * DO NOT EDIT
+ * edit firmware/sc14421_II_sniff_sync.asm instead */
+#define SC14421_II_SNIFF_SYNC_LABELS \
+	.jump      = { \
+		0x03, 0x05, 0x07, 0x09, 0x0b, 0x0d, 0x0f, 0x11, \
+		0x13, 0x15, 0x17, 0x19, 0x1c, 0x1e, 0x20, 0x22, \
+		0x24, 0x26, 0x28, 0x2a, 0x2c, 0x2e, 0x30, 0x32 \
+	}, \
+	.patch     = { \
+		0x04, 0x06, 0x08, 0x0a, 0x0c, 0x0e, 0x10, 0x12, \
+		0x14, 0x16, 0x18, 0x1a, 0x1d, 0x1f, 0x21, 0x23, \
+		0x25, 0x27, 0x29, 0x2b, 0x2d, 0x2f, 0x31, 0x33 \
+	}, \
+	.patch_b   = { \
+		0x38, 0x3a, 0x3c, 0x3e, 0x40, 0x42, 0x44, 0x46, \
+		0x48, 0x4a, 0x4c, 0x4e, 0x52, 0x54, 0x56, 0x58, \
+		0x5a, 0x5c, 0x5e, 0x60, 0x62, 0x64, 0x66, 0x68 \
+	}, \
+	.recv      = 0x6d, \
+	.recv_b    = 0x74, \
+	.recv_next = 0xd5, \
+	.pp_found  = 0xd8, \
+	.pp_search = 0xc4
 extern unsigned char sc14421_III_sniff_scan_fw[509];
 /* sc14421_III_sniff_scan.asm-Includefile fr C-Programm */
 /* Ende Includefile fr C-Programm */
 extern unsigned char sc14421_III_sniff_sync_fw[509];
 /* sc14421_III_sniff_sync.asm-Includefile fr C-Programm */
 #define PP0III 0x4
-#define PP2III 0x6
-#define PP4III 0x8
-#define PP6III 0xA
-#define PP8III 0xC
-#define PP10III 0xE
-#define PP12III 0x11
-#define PP14III 0x13
-#define PP16III 0x15
-#define PP18III 0x17
-#define PP20III 0x19
-#define PP22III 0x1B
+#define PP1III 0x6
+#define PP2III 0x8
+#define PP3III 0xA
+#define PP4III 0xC
+#define PP5III 0xE
+#define PP6III 0x10
+#define PP7III 0x12
+#define PP8III 0x14
+#define PP9III 0x16
+#define PP10III 0x18
+#define PP11III 0x1A
+#define PP12III 0x1D
+#define PP13III 0x1F
+#define PP14III 0x21
+#define PP15III 0x23
+#define PP16III 0x25
+#define PP17III 0x27
+#define PP18III 0x29
+#define PP19III 0x2B
+#define PP20III 0x2D
+#define PP21III 0x2F
+#define PP22III 0x31
+#define PP23III 0x33
 #define JP0III 0x3
-#define JP2III 0x5
-#define JP4III 0x7
-#define JP6III 0x9
-#define JP8III 0xB
-#define JP10III 0xD
-#define JP12III 0x10
-#define JP14III 0x12
-#define JP16III 0x14
-#define JP18III 0x16
-#define JP20III 0x18
-#define JP22III 0x1A
-#define RecvNextIII 0xCF
-#define PPFoundIII 0xD2
-#define RecvIII 0x1F
+#define JP1III 0x5
+#define JP2III 0x7
+#define JP3III 0x9
+#define JP4III 0xB
+#define JP5III 0xD
+#define JP6III 0xF
+#define JP7III 0x11
+#define JP8III 0x13
+#define JP9III 0x15
+#define JP10III 0x17
+#define JP11III 0x19
+#define JP12III 0x1C
+#define JP13III 0x1E
+#define JP14III 0x20
+#define JP15III 0x22
+#define JP16III 0x24
+#define JP17III 0x26
+#define JP18III 0x28
+#define JP19III 0x2A
+#define JP20III 0x2C
+#define JP21III 0x2E
+#define JP22III 0x30
+#define JP23III 0x32
+#define PP0IIIB 0x38
+#define PP1IIIB 0x3A
+#define PP2IIIB 0x3C
+#define PP3IIIB 0x3E
+#define PP4IIIB 0x40
+#define PP5IIIB 0x42
+#define PP6IIIB 0x44
+#define PP7IIIB 0x46
+#define PP8IIIB 0x48
+#define PP9IIIB 0x4A
+#define PP10IIIB 0x4C
+#define PP11IIIB 0x4E
+#define PP12IIIB 0x52
+#define PP13IIIB 0x54
+#define PP14IIIB 0x56
+#define PP15IIIB 0x58
+#define PP16IIIB 0x5A
+#define PP17IIIB 0x5C
+#define PP18IIIB 0x5E
+#define PP19IIIB 0x60
+#define PP20IIIB 0x62
+#define PP21IIIB 0x64
+#define PP22IIIB 0x66
+#define PP23IIIB 0x68
+#define RecvNextIII 0xD6
+#define PPFoundIII 0xD9
+#define RecvIII 0x6D
+#define PPSearchIII 0xC4
+#define RecvIIIB 0x74
 /* Ende Includefile fr C-Programm */
 
+/* automatically generated file
+ * DO NOT EDIT
+ * edit firmware/sc14421_III_sniff_sync.asm instead */
+#define SC14421_III_SNIFF_SYNC_LABELS \
+	.jump      = { \
+		0x03, 0x05, 0x07, 0x09, 0x0b, 0x0d, 0x0f, 0x11, \
+		0x13, 0x15, 0x17, 0x19, 0x1c, 0x1e, 0x20, 0x22, \
+		0x24, 0x26, 0x28, 0x2a, 0x2c, 0x2e, 0x30, 0x32 \
+	}, \
+	.patch     = { \
+		0x04, 0x06, 0x08, 0x0a, 0x0c, 0x0e, 0x10, 0x12, \
+		0x14, 0x16, 0x18, 0x1a, 0x1d, 0x1f, 0x21, 0x23, \
+		0x25, 0x27, 0x29, 0x2b, 0x2d, 0x2f, 0x31, 0x33 \
+	}, \
+	.patch_b   = { \
+		0x38, 0x3a, 0x3c, 0x3e, 0x40, 0x42, 0x44, 0x46, \
+		0x48, 0x4a, 0x4c, 0x4e, 0x52, 0x54, 0x56, 0x58, \
+		0x5a, 0x5c, 0x5e, 0x60, 0x62, 0x64, 0x66, 0x68 \
+	}, \
+	.recv      = 0x6d, \
+	.recv_b    = 0x74, \
+	.recv_next = 0xd6, \
+	.pp_found  = 0xd9, \
+	.pp_search = 0xc4
+
 #endif
@@ -0,0 +1,407 @@
+/*
+ * com_on_air_cs - basic driver for the Dosch and Amand "com on air" cards
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * authors:
+ * (C) 2008  Andreas Schuler <krater at badterrorist dot com>
+ * (C) 2008  Matthias Wenzel <dect at mazzoo dot de>
+ *
+ */
+
+/*
+ * the DIP firmware images. the module carries one scan and one sync
+ * image per radio type (sc14421_firmware.c), COA_IOCTL_FIRMWARE replaces
+ * them with images from request_firmware(), see sc14421_fw_load(). all
+ * cards share one set of images.
+ *
+ * an image file is the assembled code bank (firmware/Makefile, p2bin,
+ * 16 bit little endian words) followed by the label list asl writes
+ * ("#define PP0II 0x4" lines), so the labels move with the code.
+ *
+ * each card remembers the image in its code bank. loading the same image
+ * again only restores the words the sniffer patches, which makes mode
+ * switches cheap.
+ */
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+#include <linux/mutex.h>
+
+#include "sc14421.h"
+#include "dip_opcodes.h"
+#include "sc14421_loader.h"
+#include "sc14421_firmware.h"
+
+
+#define SC14421_FW_RADIOS	2	/* COA_RADIO_TYPE_II, _III */
+
+static const char *sc14421_fw_names[SC14421_FW_RADIOS][SC14421_FW_IMAGES] =
+{
+	{ "coa/sc14421_II_sniff_scan.fw",  "coa/sc14421_II_sniff_sync.fw"  },
+	{ "coa/sc14421_III_sniff_scan.fw", "coa/sc14421_III_sniff_sync.fw" },
+};
+
+/* compiled into the module, never freed. firmware/label2c generates
+ * the labels of the sync images, the scan images get theirs from
+ * sc14421_fw_init() */
+static struct sc14421_fw sc14421_fw_builtins[SC14421_FW_RADIOS][SC14421_FW_IMAGES] =
+{
+	{
+		{ .code = sc14421_II_sniff_scan_fw },
+		{ .code = sc14421_II_sniff_sync_fw, SC14421_II_SNIFF_SYNC_LABELS },
+	},
+	{
+		{ .code = sc14421_III_sniff_scan_fw },
+		{ .code = sc14421_III_sniff_sync_fw, SC14421_III_SNIFF_SYNC_LABELS },
+	},
+};
+
+/* the images sniffer_init() uploads, each holds a reference */
+static struct sc14421_fw *sc14421_fw_cache[SC14421_FW_RADIOS][SC14421_FW_IMAGES];
+static DEFINE_MUTEX(sc14421_fw_lock);
+
+
+static void sc14421_fw_release(struct kref *ref)
+{
+	/* builtins keep a reference of their own */
+	kfree(container_of(ref, struct sc14421_fw, ref));
+}
+
+static void sc14421_fw_install(int radio, int image, struct sc14421_fw *fw)
+{
+	struct sc14421_fw *old;
+
+	mutex_lock(&sc14421_fw_lock);
+	old = sc14421_fw_cache[radio][image];
+	sc14421_fw_cache[radio][image] = fw;
+	mutex_unlock(&sc14421_fw_lock);
+
+	if (old)
+		sc14421_fw_put(old);
+}
+
+static void sc14421_fw_no_labels(struct sc14421_fw *fw)
+{
+	memset(fw->jump, 0xff, sizeof(fw->jump));
+	memset(fw->patch, 0xff, sizeof(fw->patch));
+	memset(fw->patch_b, 0xff, sizeof(fw->patch_b));
+	fw->recv      = -1;
+	fw->recv_b    = -1;
+	fw->recv_next = -1;
+	fw->pp_found  = -1;
+	fw->pp_search = -1;
+}
+
+/* the slot table selects the buffers of slot n with BK_C at JPn, the
+ * upper three bits pick the RAM bank, the fourth its half */
+static int sc14421_fw_banks(struct sc14421_fw *fw)
+{
+	unsigned char page;
+	int slot;
+
+	for (slot = 0; slot < 24; slot++)
+	{
+		if (fw->code[fw->jump[slot] * 2] != BK_C)
+			return -EINVAL;
+		page = fw->code[fw->jump[slot] * 2 + 1];
+
+		fw->bank[slot]   = SC14421_RAMBANK0 + ((page >> 5) << 2);
+		fw->memofs[slot] = (page & 0x10) ? 0x80 : 0x00;
+	}
+	return 0;
+}
+
+void sc14421_fw_init(void)
+{
+	int radio, image;
+
+	for (radio = 0; radio < SC14421_FW_RADIOS; radio++)
+	{
+		sc14421_fw_no_labels(&sc14421_fw_builtins[radio][SC14421_FW_SCAN]);
+		if (sc14421_fw_banks(&sc14421_fw_builtins[radio][SC14421_FW_SYNC]))
+			printk("com_on_air_cs: builtin sync image without slot table\n");
+		for (image = 0; image < SC14421_FW_IMAGES; image++)
+			kref_init(&sc14421_fw_builtins[radio][image].ref);
+		sc14421_fw_builtin(radio);
+	}
+}
+
+void sc14421_fw_exit(void)
+{
+	int radio, image;
+
+	for (radio = 0; radio < SC14421_FW_RADIOS; radio++)
+		for (image = 0; image < SC14421_FW_IMAGES; image++)
+			sc14421_fw_install(radio, image, NULL);
+}
+
+/* request_firmware() name of an image, NULL for unknown radios */
+const char *sc14421_fw_name(int radio_type, int image)
+{
+	if ( (radio_type < 0) || (radio_type >= SC14421_FW_RADIOS) )
+		return NULL;
+	return sc14421_fw_names[radio_type][image];
+}
+
+/* the current image, NULL for unknown radios. drop it with
+ * sc14421_fw_put() */
+struct sc14421_fw *sc14421_fw_get(int radio_type, int image)
+{
+	struct sc14421_fw *fw;
+
+	if ( (radio_type < 0) || (radio_type >= SC14421_FW_RADIOS) )
+		return NULL;
+
+	mutex_lock(&sc14421_fw_lock);
+	fw = sc14421_fw_cache[radio_type][image];
+	kref_get(&fw->ref);
+	mutex_unlock(&sc14421_fw_lock);
+
+	return fw;
+}
+
+void sc14421_fw_put(struct sc14421_fw *fw)
+{
+	kref_put(&fw->ref, sc14421_fw_release);
+}
+
+/* back to the images compiled into the module */
+int sc14421_fw_builtin(int radio_type)
+{
+	struct sc14421_fw *fw;
+	int image;
+
+	if ( (radio_type < 0) || (radio_type >= SC14421_FW_RADIOS) )
+		return -ENODEV;
+
+	for (image = 0; image < SC14421_FW_IMAGES; image++)
+	{
+		fw = &sc14421_fw_builtins[radio_type][image];
+		kref_get(&fw->ref);
+		sc14421_fw_install(radio_type, image, fw);
+	}
+	return 0;
+}
+
+
+/* one "#define <label><radio>[B] <value>" line of the label list.
+ * labels the sniffer doesn't patch are ignored. */
+static int sc14421_fw_label(struct sc14421_fw *fw, const char *line, int len)
+{
+	char name[32];
+	unsigned long value;
+	unsigned long slot;
+	char *end;
+	int b = 0;
+	int n;
+
+	if (len >= sizeof(name))
+		return 0;
+	memcpy(name, line, len);
+	name[len] = 0;
+
+	end = strchr(name, ' ');
+	if (!end)
+		return 0;
+	*end++ = 0;
+	value = simple_strtoul(end, NULL, 0);
+
+	/* strip the radio type: PP0II, PP0IIB, PP0III, PP0IIIB */
+	n = strlen(name);
+	if ( (n > 4) && !strcmp(name + n - 4, "IIIB") )
+	{
+		n -= 4;
+		b  = 1;
+	}
+	else if ( (n > 3) && !strcmp(name + n - 3, "IIB") )
+	{
+		n -= 3;
+		b  = 1;
+	}
+	else if ( (n > 3) && !strcmp(name + n - 3, "III") )
+		n -= 3;
+	else if ( (n > 2) && !strcmp(name + n - 2, "II") )
+		n -= 2;
+	else
+		return 0;
+	name[n] = 0;
+
+	if (value >= SC14421_FW_SIZE / 2)
+	{
+		printk("com_on_air_cs: firmware label %s out of range\n", name);
+		return -EINVAL;
+	}
+
+	if (!strcmp(name, "Recv"))
+	{
+		if (b)
+			fw->recv_b = value;
+		else
+			fw->recv = value;
+	}
+	else if (b)
+	{
+		if (strncmp(name, "PP", 2))
+			return 0;
+		slot = simple_strtoul(name + 2, &end, 10);
+		if ( (end != name + 2) && !*end && (slot < 24) )
+			fw->patch_b[slot] = value;
+	}
+	else if (!strcmp(name, "RecvNext"))
+		fw->recv_next = value;
+	else if (!strcmp(name, "PPFound"))
+		fw->pp_found = value;
+	else if (!strcmp(name, "PPSearch"))
+		fw->pp_search = value;
+	else if (!strncmp(name, "PP", 2) || !strncmp(name, "JP", 2))
+	{
+		slot = simple_strtoul(name + 2, &end, 10);
+		if ( (end == name + 2) || *end || (slot > 23) )
+			return 0;
+		if (name[0] == 'P')
+			fw->patch[slot] = value;
+		else
+			fw->jump[slot] = value;
+	}
+
+	return 0;
+}
+
+static int sc14421_fw_check(struct sc14421_fw *fw)
+{
+	int slot;
+
+	for (slot = 0; slot < 24; slot++)
+	{
+		if ( (fw->jump[slot] < 0) || (fw->patch[slot] < 0) ||
+		     (fw->patch_b[slot] < 0) )
+			return -EINVAL;
+	}
+
+	if ( (fw->recv < 0) || (fw->recv_b < 0) || (fw->recv_next < 0) ||
+	     (fw->pp_found < 0) || (fw->pp_search < 0) )
+		return -EINVAL;
+
+	return sc14421_fw_banks(fw);
+}
+
+/* parse an image file and make it the current image */
+int sc14421_fw_load(int radio_type, int image, const u8 *data, size_t size)
+{
+	struct sc14421_fw *fw;
+	unsigned char *code;
+	const u8 *p, *eol, *end = data + size;
+	int i, ret;
+
+	if ( (radio_type < 0) || (radio_type >= SC14421_FW_RADIOS) )
+		return -ENODEV;
+	if (size < SC14421_FW_SIZE)
+		return -EINVAL;
+
+	fw = kzalloc(sizeof(*fw) + SC14421_FW_SIZE, GFP_KERNEL);
+	if (!fw)
+		return -ENOMEM;
+	kref_init(&fw->ref);
+
+	/* opcode first, like to_dip() wants it */
+	code = (unsigned char *) (fw + 1);
+	for (i = 0; i < SC14421_FW_SIZE; i += 2)
+	{
+		code[i]     = data[i + 1];
+		code[i + 1] = data[i];
+	}
+	fw->code = code;
+
+	sc14421_fw_no_labels(fw);
+
+	for (p = data + SC14421_FW_SIZE; p < end; p = eol + 1)
+	{
+		eol = memchr(p, '\n', end - p);
+		if (!eol)
+			eol = end;
+		if ( (eol - p > 8) && !memcmp(p, "#define ", 8) )
+		{
+			ret = sc14421_fw_label(fw, (const char *) p + 8,
+					       eol - p - 8);
+			if (ret)
+				goto load_out;
+		}
+	}
+
+	if (image == SC14421_FW_SYNC)
+	{
+		ret = sc14421_fw_check(fw);
+		if (ret)
+		{
+			printk("com_on_air_cs: %s lacks labels\n",
+			       sc14421_fw_names[radio_type][image]);
+			goto load_out;
+		}
+	}
+
+	sc14421_fw_install(radio_type, image, fw);
+	return 0;
+
+load_out:
+	kfree(fw);
+	return ret;
+}
+
+
+/* words of the sync image the sniffer patches, see sniffer.c */
+static void sc14421_fw_restore(volatile uint16_t *sc14421_base,
+			       struct sc14421_fw *fw)
+{
+	unsigned char *code = (unsigned char *) fw->code;
+	int slot;
+
+	if (fw->pp_found < 0)
+		return;
+
+	for (slot = 0; slot < 24; slot++)
+	{
+		to_dip(sc14421_base + fw->patch[slot] * 2,
+		       code + fw->patch[slot] * 2, 2);
+		to_dip(sc14421_base + fw->patch_b[slot] * 2,
+		       code + fw->patch_b[slot] * 2, 2);
+	}
+	to_dip(sc14421_base + fw->pp_found * 2, code + fw->pp_found * 2, 2);
+	to_dip(sc14421_base + fw->pp_search * 2, code + fw->pp_search * 2, 2);
+}
+
+/*
+ * put fw into the code bank of a stopped DIP. the card keeps a reference
+ * on it, dev->dip_fw is what the sniffer patches. if fw is there already
+ * only the patched words are reset.
+ */
+void sc14421_fw_upload(struct coa_info *dev, struct sc14421_fw *fw)
+{
+	volatile uint16_t *sc14421_base = dev->sc14421_base;
+
+	SC14421_switch_to_bank(dev, SC14421_DIPSTOPPED | SC14421_CODEBANK);
+
+	if (dev->dip_fw == fw)
+	{
+		sc14421_fw_restore(sc14421_base, fw);
+		return;
+	}
+
+	to_dip(sc14421_base, (unsigned char *) fw->code, SC14421_FW_SIZE);
+
+	kref_get(&fw->ref);
+	sc14421_fw_forget(dev);
+	dev->dip_fw = fw;
+}
+
+/* the code bank no longer holds dev->dip_fw, e.g. a new card */
+void sc14421_fw_forget(struct coa_info *dev)
+{
+	if (dev->dip_fw)
+		sc14421_fw_put(dev->dip_fw);
+	dev->dip_fw = NULL;
+}
@@ -0,0 +1,66 @@
+/*
+ * com_on_air_cs - basic driver for the Dosch and Amand "com on air" cards
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * authors:
+ * (C) 2008  Andreas Schuler <krater at badterrorist dot com>
+ * (C) 2008  Matthias Wenzel <dect at mazzoo dot de>
+ *
+ */
+
+#ifndef SC14421_LOADER_H
+#define SC14421_LOADER_H
+
+#include <linux/kref.h>
+
+#include "com_on_air.h"
+
+/* every image fills the code bank: 254 instructions of two bytes */
+#define SC14421_FW_SIZE		508
+
+/* the images of a radio type, see sc14421_fw_get() */
+#define SC14421_FW_SCAN		0
+#define SC14421_FW_SYNC		1
+#define SC14421_FW_IMAGES	2
+
+/*
+ * a DIP program and the labels the sniffer patches it at. the sync
+ * images have all of them, the scan images none (-1). bank[] and
+ * memofs[] are where the sync image keeps each slot's buffers.
+ */
+struct sc14421_fw
+{
+	struct kref		ref;
+	const unsigned char	*code;		/* one byte per DIP word */
+
+	int			jump[24];	/* JPn, slot n in SlotTable */
+	int			patch[24];	/* PPn, entry of slot n */
+	int			patch_b[24];	/* PPnB, the same in SlotTableB */
+	int			recv;		/* Recv */
+	int			recv_b;		/* RecvB */
+	int			recv_next;	/* RecvNext */
+	int			pp_found;	/* PPFound */
+	int			pp_search;	/* PPSearch */
+
+	unsigned char		bank[24];	/* RAM bank of slot n, BK_C at JPn */
+	unsigned char		memofs[24];	/* its half of that bank */
+};
+
+void               sc14421_fw_init(void);
+void               sc14421_fw_exit(void);
+
+const char        *sc14421_fw_name(int radio_type, int image);
+struct sc14421_fw *sc14421_fw_get(int radio_type, int image);
+void               sc14421_fw_put(struct sc14421_fw *fw);
+int                sc14421_fw_load(int radio_type, int image,
+				   const u8 *data, size_t size);
+int                sc14421_fw_builtin(int radio_type);
+
+void               sc14421_fw_upload(struct coa_info *dev,
+				     struct sc14421_fw *fw);
+void               sc14421_fw_forget(struct coa_info *dev);
+
+#endif
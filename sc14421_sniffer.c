@@ -13,23 +13,55 @@
 
 #include <linux/kernel.h>
 #include <linux/module.h>
-#include <linux/kfifo.h>
+#include <linux/ktime.h>
+#include <asm/div64.h>
 
 #include "sc14421.h"
 #include "dip_opcodes.h"
 #include "com_on_air.h"
 #include "sc14421_sniffer.h"
-#include "sc14421_firmware.h"
+#include "sc14421_loader.h"
 #include "dect.h"
 
 
 /* dip config register control */
 unsigned char dip_ctrl[] = {0xc2,0x05,0x00,0x03,0x00,0x00};
 
-/* rf register type II card */
-unsigned char radio_II_chan[]  = {0x54,0x80,0x09/* patch */,0xa0,0x00,0x00};
-/* rf register type III card */
-unsigned char radio_III_chan[] = {0x32,0x20,0x28,0x01,0xc1,0x1b};
+static void sniffer_tune_II(unsigned char *reg, int channel)
+{
+	reg[0] = (reg[0] & 0xC1) | (channel << 1);
+}
+
+static void sniffer_tune_III(unsigned char *reg, int channel)
+{
+	reg[2] = channel << 2;
+}
+
+static const struct sniffer_radio sniffer_radios[] =
+{
+	[COA_RADIO_TYPE_II] =
+	{
+		.type = COA_RADIO_TYPE_II,
+		.reg  = {0x54,0x80,0x09/* patch */,0xa0,0x00,0x00},
+		.mode = 0x00,
+		.tune = sniffer_tune_II,
+	},
+	[COA_RADIO_TYPE_III] =
+	{
+		.type = COA_RADIO_TYPE_III,
+		.reg  = {0x32,0x20,0x28,0x01,0xc1,0x1b},
+		.mode = 0x08,
+		.tune = sniffer_tune_III,
+	},
+};
+
+/* NULL for radios we don't know */
+const struct sniffer_radio *sniffer_radio(unsigned int radio_type)
+{
+	if (radio_type >= ARRAY_SIZE(sniffer_radios))
+		return NULL;
+	return &sniffer_radios[radio_type];
+}
 
 /* dip register */
 unsigned char dip_register[] = {0x15,0xa0,0xff,0x00/* &0x3f */,0x5f,0x04,0x00};
@@ -38,80 +70,123 @@ unsigned char dip_register[] = {0x15,0xa0,0xff,0x00/* &0x3f */,0x5f,0x04,0x00};
 unsigned char dip_mode_fp_pp[] = {0x27,0x00,0xff,0x00,0x5f,0x05,0x00};
 
 
-unsigned char fppacket[53] = {0xAA,0xAA,0xAA,0xE9,0x8A};
-unsigned char pppacket[53] = {0x55,0x55,0x55,0x16,0x75};
+/* preamble and sync word in front of received packets */
+unsigned char fppacket[5] = {0xAA,0xAA,0xAA,0xE9,0x8A};
+unsigned char pppacket[5] = {0x55,0x55,0x55,0x16,0x75};
 
 
-/* FIXME:auto-generate all this stuff */
 
-int sync_jumptable[] = {
-	 JP0II, 0,
-	 JP2II, 0,
-	 JP4II, 0,
-	 JP6II, 0,
-	 JP8II, 0,
-	JP10II, 0,
-	JP12II, 0,
-	JP14II, 0,
-	JP16II, 0,
-	JP18II, 0,
-	JP20II, 0,
-	JP22II, 0
-};
-int sync_patchtable[] = {
-	 PP0II, 0,
-	 PP2II, 0,
-	 PP4II, 0,
-	 PP6II, 0,
-	 PP8II, 0,
-	PP10II, 0,
-	PP12II, 0,
-	PP14II, 0,
-	PP16II, 0,
-	PP18II, 0,
-	PP20II, 0,
-	PP22II, 0
-};
-/* FIXME:end */
-
-int sync_banktable[] = {
-	SC14421_RAMBANK1,
-	SC14421_RAMBANK1,
-	SC14421_RAMBANK1,
-	SC14421_RAMBANK1,
-	SC14421_RAMBANK2,
-	SC14421_RAMBANK2,
-	SC14421_RAMBANK2,
-	SC14421_RAMBANK2,
-	SC14421_RAMBANK3,
-	SC14421_RAMBANK3,
-	SC14421_RAMBANK3,
-	SC14421_RAMBANK3,
-	SC14421_RAMBANK4,
-	SC14421_RAMBANK4,
-	SC14421_RAMBANK4,
-	SC14421_RAMBANK4,
-	SC14421_RAMBANK5,
-	SC14421_RAMBANK5,
-	SC14421_RAMBANK5,
-	SC14421_RAMBANK5,
-	SC14421_RAMBANK6,
-	SC14421_RAMBANK6,
-	SC14421_RAMBANK6,
-	SC14421_RAMBANK6
-};
+
+static void sniffer_timestamp(struct coa_timestamp *timestamp, s64 ts)
+{
+	u64 ns = ts;
+
+	timestamp->tv_nsec = do_div(ns, NSEC_PER_SEC);
+	timestamp->tv_sec  = ns;
+}
+
+/*
+ * the interrupt fires at a slot boundary (slot 12 for 0x01, the end of
+ * the frame for 0x08), so the stamp taken at irq entry tells us when the
+ * frame started - plus whatever irq latency we suffered.
+ * latency only ever makes us late, so follow earlier stamps right away
+ * and later ones only slowly, unless we're off by more than a slot
+ * (first frame, lost interrupts).
+ */
+static void sniffer_update_frame_ts(struct coa_info *dev, int boundary_slot, s64 ts)
+{
+	struct sniffer_cfg *config = dev->sniffer_config;
+	s64 seen = ts - boundary_slot * DECT_SLOT_NS;
+	s64 diff = seen - config->frame_ts;
+
+	if ( (diff < 0) || (diff > DECT_SLOT_NS) )
+		config->frame_ts = seen;
+	else
+		config->frame_ts += diff >> 4;
+}
+
+static s64 sniffer_slot_ts(struct coa_info *dev, int slot)
+{
+	return dev->sniffer_config->frame_ts + slot * DECT_SLOT_NS;
+}
+
+
+/* returns 1 if the packet should be queued, see struct coa_filter */
+static int sniffer_filter_accept(struct coa_filter *filter, struct sniffed_packet *packet)
+{
+	struct coa_filter_rule *rule;
+	uint8_t ta = 1 << (packet->data[5] >> 5);
+	int bfield = dect_has_b_field(packet->data) ?
+			COA_FILTER_BFIELD_YES : COA_FILTER_BFIELD_NO;
+	int i;
+
+	if (!filter->count)
+		return 1;
+
+	for (i = 0; i < filter->count; i++)
+	{
+		rule = &filter->rule[i];
+
+		if (!(rule->slots & (1 << packet->slot)))
+			continue;
+		if (!(rule->ta & ta))
+			continue;
+		if (rule->bfield && (rule->bfield != bfield))
+			continue;
+		if (packet->rssi < rule->rssi_min)
+			continue;
+
+		return rule->action == COA_FILTER_ACCEPT;
+	}
+
+	return filter->default_action == COA_FILTER_ACCEPT;
+}
+
+/* queue one record for all readers, the ring never fills up. a reader
+ * that falls behind loses records on its own, see coa_ring.c */
+static void sniffer_queue(struct coa_info *dev, int type, void *data, int len)
+{
+	int ret;
+
+	ret = coa_ring_put(&dev->rx_ring, type, data, len);
+	if (ret <= 0)
+		printk("com_on_air_cs: coa_ring_put() = %d\n", ret);
+}
 
 
 void sniffer_init(struct coa_info *dev)
 {
+	struct sc14421_fw *fw = NULL;
+	unsigned long flags;
+	int image = SC14421_FW_SYNC;
 	int ret;
 
+	/* stop the DIP, then keep the interrupt off and wait for the bottom
+	 * half it may have queued: neither may run while we reload */
+	spin_lock_irqsave(&dev->dip_lock, flags);
 	SC14421_switch_to_bank(
-		dev->sc14421_base,
+		dev,
 		SC14421_DIPSTOPPED | SC14421_CODEBANK
 		);
+	spin_unlock_irqrestore(&dev->dip_lock, flags);
+
+	disable_irq(dev->irq);
+	tasklet_kill(&dev->sniffer_tasklet);
+
+	/* getting the image may sleep, the reload switches banks and
+	 * runs under dip_lock. the rssi sweep uses the sync firmware. */
+	if ( (dev->sniffer_config->snifftype == SNIFF_SCANFP) ||
+	     (dev->sniffer_config->snifftype == SNIFF_SCANPP) )
+		image = SC14421_FW_SCAN;
+	if (dev->radio)
+		fw = sc14421_fw_get(dev->radio->type, image);
 
-	ret = SC14421_check_RAM(dev->sc14421_base);
+	spin_lock_irqsave(&dev->dip_lock, flags);
+
+	memset(dev->sniffer_config->rxbuf, 0, sizeof(dev->sniffer_config->rxbuf));
+	memcpy(dev->sniffer_config->rxbuf, fppacket, sizeof(fppacket));
+
+	ret = SC14421_check_RAM(dev);
 	if (ret)
 		printk("Found %u memory r/w errors \n\n", ret);
 
@@ -119,26 +194,43 @@ void sniffer_init(struct coa_info *dev)
 	{
 		case SNIFF_SCANFP:
 		case SNIFF_SCANPP:
-			sniffer_init_sniff_scan(dev);
+			sniffer_init_sniff_scan(dev, fw);
 			break;
 		case SNIFF_SYNC:
-			sniffer_init_sniff_sync(dev);
+			sniffer_init_sniff_sync(dev, fw);
+			break;
+		case SNIFF_RSSI:
+			sniffer_init_sniff_rssi(dev, fw);
 			break;
 	}
-}
 
+	spin_unlock_irqrestore(&dev->dip_lock, flags);
+
+	if (fw)
+		sc14421_fw_put(fw);
+	enable_irq(dev->irq);
+}
 
 void set_channel(struct coa_info *dev, int ch, int sync_slot, int sync_frame, unsigned char dipmode , unsigned char bank)
 {
+	const struct sniffer_radio *radio = dev->radio;
 	int channel,memofs;
+	/* the scan firmware keeps the radio setup where it always was */
+	int radio_ofs = 0x4A, dipreg_ofs = 0x50, mode_ofs = 0x58;
         unsigned short *sc14421_base = dev->sc14421_base;
+	/* the tables are templates shared by all cards, patch a copy */
+	unsigned char reg[SNIFF_RADIO_LEN];
+	unsigned char mode[ARRAY_SIZE(dip_mode_fp_pp)];
+
+	memcpy(reg, radio->reg, sizeof(reg));
+	memcpy(mode, dip_mode_fp_pp, sizeof(mode));
 
 //	printk("set channel:%u slot:%u frame#:%u dipmode:%u bank:%x\n",ch,sync_slot,sync_frame,dipmode,bank);
 
-	if ( (sync_slot/2) % 2)
-		memofs = 0x80;
-	else
+	if (sync_slot < 0)
 		memofs = 0x00;
+	else
+		memofs = dev->dip_fw->memofs[sync_slot];
 
 
 	if (ch<10)
@@ -146,125 +238,281 @@ void set_channel(struct coa_info *dev, int ch, int sync_slot, int sync_frame, un
 	else
 		channel = ch;
 
-	SC14421_switch_to_bank(sc14421_base, dipmode | SC14421_RAMBANK0);
+	SC14421_switch_to_bank(dev, dipmode | SC14421_RAMBANK0);
 	to_dip(sc14421_base + 0x10, dip_ctrl, ARRAY_SIZE(dip_ctrl));
 
 
-	SC14421_switch_to_bank(sc14421_base, dipmode | bank);
+	SC14421_switch_to_bank(dev, dipmode | bank);
 
 	switch(dev->sniffer_config->snifftype)
 	{
 	case SNIFF_SYNC:
+	case SNIFF_RSSI:
 		if (sync_slot > 11)
 		{
-			dip_mode_fp_pp[0] &= 0xFE;
-			dip_mode_fp_pp[6] = sync_frame;
+			mode[0] &= 0xFE;
+			mode[6] = sync_frame;
 		}else{
-			dip_mode_fp_pp[0] |= 0x01;
-			dip_mode_fp_pp[6] = sync_frame;
+			mode[0] |= 0x01;
+			mode[6] = sync_frame;
 		}
+		radio_ofs  = SNIFF_RADIO;
+		dipreg_ofs = SNIFF_DIPREG;
+		mode_ofs   = SNIFF_MODE;
 		break;
 	case SNIFF_SCANFP:
-		dip_mode_fp_pp[0] |= 0x01;
+		mode[0] |= 0x01;
 		break;
 	case SNIFF_SCANPP:
-		dip_mode_fp_pp[0] &= 0xFE;
+		mode[0] &= 0xFE;
 		break;
 	default:
 		printk("ERROR: this snifftype is currently not "
 			"supported. please update the driver\n");
 	}
 
-	switch(dev->radio_type)
+	radio->tune(reg, channel);
+	mode[0] = (mode[0] & 0xF7) | radio->mode;
+	to_dip(sc14421_base + memofs + radio_ofs, reg, SNIFF_RADIO_LEN);
+
+	to_dip(sc14421_base + memofs + mode_ofs, mode, ARRAY_SIZE(mode));
+	to_dip(sc14421_base + memofs + dipreg_ofs, dip_register, ARRAY_SIZE(dip_register));
+
+}
+
+/* upload fw, the current image from sc14421_fw_get(), into the stopped
+ * DIP. see sc14421_loader.c */
+static int sniffer_load_fw(struct coa_info *dev, struct sc14421_fw *fw)
+{
+	if (!fw)
 	{
-	case COA_RADIO_TYPE_II:
-		radio_II_chan[0] = (radio_II_chan[0] & 0xC1) | (channel << 1);
-		dip_mode_fp_pp[0] &= 0xF7;
-		
-		to_dip(sc14421_base + memofs + 0x4A, radio_II_chan, ARRAY_SIZE(radio_II_chan));
-		break;
-	case COA_RADIO_TYPE_III:
-		radio_III_chan[2] = channel << 2;
-		dip_mode_fp_pp[0] |= 0x08;
-		to_dip(sc14421_base + memofs + 0x4A, radio_III_chan, ARRAY_SIZE(radio_III_chan));
-		break;
-	default:
 		printk("ERROR: this radio type is currently not "
 			"supported. please update the driver\n");
+		return -ENODEV;
 	}
+	sc14421_fw_upload(dev, fw);
 
-	to_dip(sc14421_base + memofs + 0x58, dip_mode_fp_pp, ARRAY_SIZE(dip_mode_fp_pp));
-	to_dip(sc14421_base + memofs + 0x50, dip_register, ARRAY_SIZE(dip_register));
-
+	/* printk("clear interrupt\n"); */
+	SC14421_clear_interrupt(dev->sc14421_base);
+	return 0;
 }
 
-void sniffer_init_sniff_scan(struct coa_info *dev)
+void sniffer_init_sniff_scan(struct coa_info *dev, struct sc14421_fw *fw)
 {
-	volatile uint16_t *sc14421_base = dev->sc14421_base;
-
 	/* printk("loading sniff_scan firmware"); */
+	if (sniffer_load_fw(dev, fw))
+		return;
+
+	sniffer_scan_reset(dev);
 
-	SC14421_switch_to_bank(sc14421_base, SC14421_DIPSTOPPED | SC14421_CODEBANK);
+	set_channel(dev, dev->sniffer_config->channel, -1, -1, SC14421_DIPSTOPPED, SC14421_RAMBANK1);
+
+	/* printk("starting dip\n"); */
+	SC14421_switch_to_bank(dev, SC14421_RAMBANK0);
 
-	switch(dev->radio_type)
+}
+
+
+/*
+ * which slots may be received, see COA_IOCTL_SLOT. slots whose state
+ * changes get repatched. returns 1 if the mask changed.
+ */
+static int sniffer_update_slotmask(struct sniffer_cfg *config)
+{
+	struct dect_slot_info *slottable = config->slottable;
+	uint32_t mask = COA_FILTER_SLOTS_ALL;
+	uint32_t changed;
+	int p = config->pinned;
+	int a;
+
+	if (p >= 0)
 	{
-	case COA_RADIO_TYPE_II:
-		/* printk(" for type II\n"); */
-		to_dip(sc14421_base, sc14421_II_sniff_scan_fw, ARRAY_SIZE(sc14421_II_sniff_scan_fw));
-		break;
-	case COA_RADIO_TYPE_III:
-		/* printk(" for type III\n"); */
-		to_dip(sc14421_base, sc14421_III_sniff_scan_fw, ARRAY_SIZE(sc14421_III_sniff_scan_fw));
-		break;
-	default:
-		printk("ERROR: this radio type is currently not "
-			"supported. please update the driver\n");
+		mask = (1 << p) | (1 << (p + 12));
+		/* keep the beacon until the pinned pair shows up */
+		if ( !slottable[p].active && !slottable[p + 12].active &&
+		     (config->beacon >= 0) )
+			mask |= (1 << config->beacon) | (1 << (config->beacon + 12));
 	}
 
-	/* printk("clear interrupt\n"); */
-	SC14421_clear_interrupt(sc14421_base);
+	changed = mask ^ config->slotmask;
+	if (!changed)
+		return 0;
+
+	config->slotmask = mask;
+	for (a = 0; a < 24; a++)
+		if ( (changed & (1 << a)) && slottable[a].active)
+			slottable[a].update = 1;
+	if (changed & COA_FILTER_SLOTS_FP)
+		config->updatefpslots = 1;
+	if (changed & COA_FILTER_SLOTS_PP)
+		config->updateppslots = 1;
+
+	return 1;
+}
+
+/* called with the tasklet disabled and dip_lock held */
+void sniffer_pin_slot(struct coa_info *dev, uint32_t slot)
+{
+	struct sniffer_cfg *config = dev->sniffer_config;
+
+	if (slot == COA_SLOT_ANY)
+		config->pinned = -1;
+	else
+		config->pinned = slot % 12;
+
+	sniffer_update_slotmask(config);
+}
+
+void sniffer_init_sniff_sync(struct coa_info *dev, struct sc14421_fw *fw)
+{
+	/* printk("loading sniff_sync firmware"); */
+	if (sniffer_load_fw(dev, fw))
+		return;
 
 	set_channel(dev, dev->sniffer_config->channel, -1, -1, SC14421_DIPSTOPPED, SC14421_RAMBANK1);
 
+	dev->sniffer_config->status = 0;
+	dev->sniffer_config->frame_ts = 0;
+	dev->sniffer_config->stage_head = 0;
+	dev->sniffer_config->stage_tail = 0;
+	sniffer_clear_slottable(dev->sniffer_config->slottable);
+	dev->sniffer_config->beacon = -1;
+	dev->sniffer_config->bearer = -1;
+	dev->sniffer_config->ho_new = -1;
+	dev->sniffer_config->frame = 1;
+	memset(dev->sniffer_config->last_ok, 0, sizeof(dev->sniffer_config->last_ok));
+	dev->sniffer_config->pscn = -1;
+	memset(dev->sniffer_config->setup_frame, 0, sizeof(dev->sniffer_config->setup_frame));
+	dev->sniffer_config->slotmask = COA_FILTER_SLOTS_ALL;
+	dev->sniffer_config->rxmask = 0;
+	dev->sniffer_config->expect_buf = -1;
+	sniffer_update_slotmask(dev->sniffer_config);
+
 	/* printk("starting dip\n"); */
-	SC14421_switch_to_bank(sc14421_base, SC14421_RAMBANK0);
+	SC14421_switch_to_bank(dev, SC14421_RAMBANK0);
 
 }
 
+/* the slots of a half frame the sweep receives on in an odd or even
+ * frame, see sniffer_rx_slots() for why 11 and 23 are left out */
+static uint32_t sniffer_rssi_slots(int first, int odd)
+{
+	uint32_t rx = 0;
+	int slot;
 
-void sniffer_init_sniff_sync(struct coa_info *dev)
+	for (slot = first + odd; slot < (first + 11); slot += 2)
+		rx |= 1 << slot;
+	return rx;
+}
+
+/* tune and patch a half frame the DIP isn't in, like the patchloop */
+static void sniffer_rssi_tune(struct coa_info *dev, unsigned char dipmode,
+			      int first, int carrier, int odd)
 {
 	volatile uint16_t *sc14421_base = dev->sc14421_base;
+	struct sc14421_fw *fw = dev->dip_fw;
+	uint32_t rx = sniffer_rssi_slots(first, odd);
+	int slot;
 
-	/* printk("loading sniff_sync firmware"); */
+	for (slot = first; slot < (first + 12); slot++)
+		if (rx & (1 << slot))
+			set_channel(dev, carrier, slot, 0, dipmode, fw->bank[slot]);
 
-	SC14421_switch_to_bank(sc14421_base, SC14421_DIPSTOPPED | SC14421_CODEBANK);
-	switch(dev->radio_type)
+	SC14421_switch_to_bank(dev, dipmode | SC14421_CODEBANK);
+
+	for (slot = first; slot < (first + 12); slot++)
 	{
-	case COA_RADIO_TYPE_II:
-		/* printk(" for type II\n"); */
-		to_dip(sc14421_base, sc14421_II_sniff_sync_fw, ARRAY_SIZE(sc14421_II_sniff_sync_fw));
-		break;
-	case COA_RADIO_TYPE_III:
-		/* printk(" for type III\n"); */
-		to_dip(sc14421_base, sc14421_III_sniff_sync_fw, ARRAY_SIZE(sc14421_III_sniff_sync_fw));
-		break;
-	default:
-		printk("ERROR: this radio type is currently not "
-			"supported. please update the driver\n");
+		if (rx & (1 << slot))
+		{
+			SC14421_write_cmd(sc14421_base, fw->patch[slot], JMP, fw->recv);
+			SC14421_write_cmd(sc14421_base, fw->patch_b[slot], JMP, fw->recv_b);
+		}
+		else if ( (slot > first) && (rx & (1 << (slot - 1))) )
+		{
+			/* the receive before already waited into this slot */
+			SC14421_write_cmd(sc14421_base, fw->patch[slot], WT, 1);
+			SC14421_write_cmd(sc14421_base, fw->patch_b[slot], WT, 1);
+		}
+		else
+		{
+			SC14421_write_cmd(sc14421_base, fw->patch[slot], WNT, 1);
+			SC14421_write_cmd(sc14421_base, fw->patch_b[slot], WNT, 1);
+		}
 	}
+}
 
-	/* printk("clear interrupt\n"); */
-	SC14421_clear_interrupt(sc14421_base);
+/*
+ * the rssi sweep doesn't look for a station: the sync firmware is patched
+ * to enter its slot table right away. the DIP stores the RSSI of a slot
+ * in its first word whether or not anything was decoded. of two
+ * neighbouring slots only one can receive, and never 11 or 23, so each
+ * carrier is measured for two frames: the even slots, then the odd ones.
+ * all slots of a frame listen on the same carrier, each half frame is
+ * retuned and repatched while the DIP is busy with the other half.
+ */
+void sniffer_init_sniff_rssi(struct coa_info *dev, struct sc14421_fw *fw)
+{
+	volatile uint16_t *sc14421_base = dev->sc14421_base;
+	struct sniffer_cfg *config = dev->sniffer_config;
+	int ch;
 
-	set_channel(dev, dev->sniffer_config->channel, -1, -1, SC14421_DIPSTOPPED, SC14421_RAMBANK1);
+	config->rssi_count = 0;
+	for (ch = 0; ch < 32; ch++)
+		if (config->rssi_carriers & (1 << ch))
+			config->rssi_list[config->rssi_count++] = ch;
+	if (!config->rssi_count)
+		return;
 
-	dev->sniffer_config->status = 0;
-	sniffer_clear_slottable(dev->sniffer_config->slottable);
+	config->rssi_index  = 0;
+	config->rssi_odd    = 0;
+	config->rssi_primed = 0;
+	memset(&config->rssi_row, 0, sizeof(config->rssi_row));
+
+	if (sniffer_load_fw(dev, fw))
+		return;
+
+	sniffer_rssi_tune(dev, SC14421_DIPSTOPPED, 0, config->rssi_list[0], 0);
+	sniffer_rssi_tune(dev, SC14421_DIPSTOPPED, 12, config->rssi_list[0], 0);
+
+	SC14421_switch_to_bank(dev, SC14421_DIPSTOPPED | SC14421_CODEBANK);
+	SC14421_write_cmd(sc14421_base, fw->pp_search, BR, fw->jump[0]);
 
 	/* printk("starting dip\n"); */
-	SC14421_switch_to_bank(sc14421_base, SC14421_RAMBANK0);
+	SC14421_switch_to_bank(dev, SC14421_RAMBANK0);
+}
+
+/*
+ * move the running DIP to config->channel without reloading the firmware
+ * or testing the RAM. only the radio registers in RAMBANK1 are rewritten,
+ * so this works while scanning and while the sync firmware is still
+ * looking for the station - once it follows the station there are slots
+ * on several banks. returns -EAGAIN if the caller has to sniffer_init().
+ */
+int sniffer_retune(struct coa_info *dev)
+{
+	volatile uint16_t *sc14421_base = dev->sc14421_base;
+	struct sniffer_cfg *config = dev->sniffer_config;
+	unsigned long flags;
+
+	if (!config || !sc14421_base)
+		return -EAGAIN;
+
+	/* the sweep picks its carriers itself */
+	if (config->snifftype == SNIFF_RSSI)
+		return 0;
+
+	if ( (config->snifftype == SNIFF_SYNC) &&
+	     (config->status & SNIFF_STATUS_FOUNDSTATION) )
+		return -EAGAIN;
 
+	spin_lock_irqsave(&dev->dip_lock, flags);
+
+	set_channel(dev, config->channel, -1, -1, 0, SC14421_RAMBANK1);
+	SC14421_WRITE(1, 0); /* drop what we got on the old channel */
+
+	spin_unlock_irqrestore(&dev->dip_lock, flags);
+
+	return 0;
 }
 
 uint8_t sniffer_irq_handler(struct coa_info *dev)
@@ -273,6 +521,9 @@ uint8_t sniffer_irq_handler(struct coa_info *dev)
 
 	if (dev->sc14421_base)
 	{
+		/* the tasklet may be patching the firmware on another cpu */
+		spin_lock(&dev->dip_lock);
+
 		irq = SC14421_clear_interrupt(dev->sc14421_base);
 
 		switch(dev->sniffer_config->snifftype)
@@ -284,63 +535,421 @@ uint8_t sniffer_irq_handler(struct coa_info *dev)
 			case SNIFF_SYNC:
 				sniffer_sniff_sync_irq(dev, irq);
 				break;
+			case SNIFF_RSSI:
+				sniffer_sniff_rssi_irq(dev, irq);
+				break;
 		}
+
+		spin_unlock(&dev->dip_lock);
 	}
 	return irq;
 }
 
+/* forget all RFPIs of an aggregated scan, see COA_IOCTL_SCANAGG */
+void sniffer_scan_reset(struct coa_info *dev)
+{
+	struct sniffer_cfg *config = dev->sniffer_config;
+
+	memset(config->scan_table, 0, sizeof(config->scan_table));
+	config->scan_summary_ts = dev->irq_timestamp;
+}
+
+static struct sniffer_station *sniffer_scan_lookup(struct sniffer_cfg *config,
+						    unsigned char *RFPI)
+{
+	struct sniffer_station *st;
+	uint32_t hash = config->channel;
+	int i;
+
+	for (i = 0; i < 5; i++)
+		hash = (hash << 8 | hash >> 24) ^ RFPI[i];
+	hash *= 0x9e370001UL;
+	hash >>= 32 - 8; /* top bits, 2^8 == COA_SCAN_MAX_STATIONS */
+
+	for (i = 0; i < COA_SCAN_MAX_STATIONS; i++)
+	{
+		st = &config->scan_table[(hash + i) % COA_SCAN_MAX_STATIONS];
+		if (!st->used)
+			return st;
+		if ( (st->channel == config->channel) &&
+		     !memcmp(st->RFPI, RFPI, 5) )
+			return st;
+	}
+	return NULL;
+}
+
+static void sniffer_scan_queue(struct coa_info *dev, struct sniffer_station *st,
+			       int event)
+{
+	struct coa_scan_station rec;
+
+	rec.event    = event;
+	rec.channel  = st->channel;
+	memcpy(rec.RFPI, st->RFPI, 5);
+	rec.rssi_min = st->rssi_min;
+	rec.rssi_max = st->rssi_max;
+	rec.reserved = 0;
+	rec.count    = st->count;
+	rec.rssi_sum = st->rssi_sum;
+	sniffer_timestamp(&rec.first_seen, st->first_seen);
+	sniffer_timestamp(&rec.last_seen, st->last_seen);
+
+	sniffer_queue(dev, COA_RECORD_SCAN, &rec, sizeof(rec));
+
+	st->count    = 0;
+	st->rssi_sum = 0;
+	st->rssi_min = 0xff;
+	st->rssi_max = 0;
+}
+
+/* one beacon of an aggregated scan */
+static void sniffer_scan_beacon(struct coa_info *dev, unsigned char *RFPI,
+				uint8_t rssi)
+{
+	struct sniffer_cfg *config = dev->sniffer_config;
+	struct sniffer_station *st, untracked;
+	int event = 0;
+
+	st = sniffer_scan_lookup(config, RFPI);
+	if (!st)
+	{
+		st = &untracked;
+		event = COA_SCAN_UNTRACKED;
+	}
+	else if (!st->used)
+	{
+		st->used = 1;
+		event = COA_SCAN_NEW;
+	}
+	if (event)
+	{
+		st->channel = config->channel;
+		memcpy(st->RFPI, RFPI, 5);
+		st->first_seen = dev->irq_timestamp;
+		st->count    = 0;
+		st->rssi_sum = 0;
+		st->rssi_min = 0xff;
+		st->rssi_max = 0;
+	}
+
+	st->last_seen = dev->irq_timestamp;
+	st->count++;
+	st->rssi_sum += rssi;
+	if (rssi < st->rssi_min)
+		st->rssi_min = rssi;
+	if (rssi > st->rssi_max)
+		st->rssi_max = rssi;
+
+	if (event)
+		sniffer_scan_queue(dev, st, event);
+}
+
+/* everything heard since the last summary, one record per station */
+static void sniffer_scan_summary(struct coa_info *dev)
+{
+	struct sniffer_cfg *config = dev->sniffer_config;
+	s64 period = (s64) dev->scan_period * NSEC_PER_MSEC;
+	int i;
+
+	if (dev->irq_timestamp - config->scan_summary_ts < period)
+		return;
+	config->scan_summary_ts = dev->irq_timestamp;
+
+	for (i = 0; i < COA_SCAN_MAX_STATIONS; i++)
+	{
+		if (config->scan_table[i].count)
+			sniffer_scan_queue(dev, &config->scan_table[i],
+					   COA_SCAN_SUMMARY);
+	}
+}
+
 void sniffer_sniff_scan_irq(struct coa_info *dev, int irq)
 {
 	volatile uint16_t *sc14421_base = dev->sc14421_base;
-	int ret;
+	unsigned char *rxbuf = dev->sniffer_config->rxbuf;
 	uint8_t station[7];
 
 	if (dev->open)
 	{
-		SC14421_switch_to_bank(sc14421_base, SC14421_RAMBANK1);
+		SC14421_switch_to_bank(dev, SC14421_RAMBANK1);
 
 		if ( (SC14421_READ(1) & 0xc0) == 0xc0) /* Checksum ok */
 		{
 			uint8_t rssi = SC14421_READ(0);
-			from_dip(fppacket + 5, sc14421_base + 6, 6);
+			from_dip(rxbuf + 5, sc14421_base + 6, 6);
 
 			SC14421_WRITE(1, 0); /* Clear Checksum-Flag */
 
-			if (dect_is_RFPI_Packet(fppacket))
+			if (dect_is_RFPI_Packet(rxbuf))
 			{
-
-				station[0] = dev->sniffer_config->channel;
-				station[1] = rssi;
-				memcpy(&station[2], &fppacket[6], 5); /* RFPI */
-
-				ret = kfifo_put(dev->rx_fifo, station, 7);
-				if (ret <= 0)
+				if (dev->scan_period)
 				{
-					printk("com_on_air_cs: rx fifo full? "
-						"kfifo_put() = %d\n", ret);
+					sniffer_scan_beacon(dev, &rxbuf[6], rssi);
+				}
+				else
+				{
+					station[0] = dev->sniffer_config->channel;
+					station[1] = rssi;
+					memcpy(&station[2], &rxbuf[6], 5); /* RFPI */
+
+					sniffer_queue(dev, COA_RECORD_STATION,
+							station, 7);
 				}
 			}
 		}
+
+		if (dev->scan_period)
+			sniffer_scan_summary(dev);
 	}
 }
 
-void sniffer_sniff_sync_irq(struct coa_info *dev, int irq)
+static void sniffer_rssi_read(struct coa_info *dev, int irq, int first)
 {
 	volatile uint16_t *sc14421_base = dev->sc14421_base;
 	struct sniffer_cfg *config = dev->sniffer_config;
-	struct sniffed_packet packet;
-	int ret;
+	struct coa_rssi_row *row = &config->rssi_row;
+	struct sc14421_fw *fw = dev->dip_fw;
+	uint32_t rx = sniffer_rssi_slots(first, config->rssi_odd);
 	int slot;
-	int a,i;
 	int memofs;
 
-	SC14421_switch_to_bank(sc14421_base, SC14421_RAMBANK1);
+	for (slot = first; slot < (first + 12); slot++)
+	{
+		if (!(rx & (1 << slot)))
+			continue;
+
+		SC14421_switch_to_bank(dev, fw->bank[slot]);
+		memofs = fw->memofs[slot];
+
+		if (irq & SNIFF_IRQ_BUF_B)
+			memofs += SNIFF_BUF_B;
+
+		row->rssi[slot] = SC14421_READ(memofs);
+		row->slots |= 1 << slot;
+	}
+}
+
+/* one row per carrier, two frames, see sniffer_init_sniff_rssi() */
+void sniffer_sniff_rssi_irq(struct coa_info *dev, int irq)
+{
+	struct sniffer_cfg *config = dev->sniffer_config;
+	struct coa_rssi_row *row = &config->rssi_row;
+	int next;
+
+	if (!config->rssi_count)
+		return;
+
+	/* the carrier of the next frame */
+	next = config->rssi_index;
+	if (config->rssi_odd)
+		next = (next + 1) % config->rssi_count;
+
+	if ( (irq & 0x09) == 0x09)
+	{
+		/* the first half wasn't retuned, so the whole next frame is
+		 * still on the current carrier and slots. measure it again. */
+		dev->stats.overruns++;
+		config->rssi_primed = 0;
+	}
+	else if ( (irq & 0x01) && config->rssi_primed)
+	{
+		sniffer_rssi_read(dev, irq, 0);
+		sniffer_rssi_tune(dev, 0, 0, config->rssi_list[next],
+				  !config->rssi_odd);
+	}
+
+	if (!(irq & 0x08))
+		return;
+
+	/* right after the start we may have joined the frame halfway */
+	if (!config->rssi_primed)
+	{
+		config->rssi_primed = 1;
+		return;
+	}
+
+	sniffer_rssi_read(dev, irq, 12);
+
+	if (config->rssi_odd)
+	{
+		row->channel = config->rssi_list[config->rssi_index];
+		row->index   = config->rssi_index;
+		row->count   = config->rssi_count;
+		sniffer_timestamp(&row->timestamp,
+				  dev->irq_timestamp - 2 * DECT_FRAME_NS);
+		sniffer_queue(dev, COA_RECORD_RSSI, row, sizeof(*row));
+
+		row->slots = 0;
+		memset(row->rssi, 0, sizeof(row->rssi));
+		if (next == 0)
+			row->sweep++;
+	}
+
+	config->rssi_index = next;
+	config->rssi_odd   = !config->rssi_odd;
+	sniffer_rssi_tune(dev, 0, 12, config->rssi_list[next], config->rssi_odd);
+}
+
+/*
+ * top half of the sync sniffer: copy the checksum flags and raw slot
+ * bytes of one half frame out of the DIP and hand them to the tasklet.
+ * this has to be quick: the DIP takes the other buffer of each slot for
+ * the next frame and comes back to this one a frame later.
+ * the slot table puts four consecutive slots into one bank, so walking
+ * the slots in order costs at most one bank switch per used bank.
+ */
+static void sniffer_stage_half(struct coa_info *dev, int irq, int first)
+{
+	volatile uint16_t *sc14421_base = dev->sc14421_base;
+	struct sniffer_cfg *config = dev->sniffer_config;
+	struct sc14421_fw *fw = dev->dip_fw;
+	struct sniffer_half *half = NULL;
+	struct sniffer_raw_slot *raw;
+	uint8_t status;
+	int active;
+	int a;
+	int memofs;
+
+	if ( (config->stage_head - config->stage_tail) < SNIFFER_STAGE_DEPTH)
+	{
+		half = &config->stage[config->stage_head % SNIFFER_STAGE_DEPTH];
+		half->irq = irq;
+		half->first = first;
+		half->timestamp = dev->irq_timestamp;
+	}
+	else
+		dev->stats.bh_overruns++;
+
+	for (a = first; a < (first + 12); a++)
+	{
+		active = !!(config->rxmask & (1 << a));
+
+		raw = half ? &half->slot[a - first] : NULL;
+		if (raw)
+			raw->active = active;
+
+		if (!active)
+			continue;
+
+		SC14421_switch_to_bank(dev, fw->bank[a]);
+		memofs = fw->memofs[a];
+
+		if (irq & SNIFF_IRQ_BUF_B)
+			memofs += SNIFF_BUF_B;
+
+		if (raw && config->burst)
+		{
+			/* the whole buffer in one go, bytes picked out after */
+			from_dip_burst(config->snapshot, sc14421_base+memofs, SNIFF_BUF_LEN);
+			from_dip_pack(&raw->rssi, config->snapshot, 1);
+			from_dip_pack(&raw->status, config->snapshot + 1, 1);
+			status = raw->status;
+			if ( (status & 0xc0) == 0xc0)
+				from_dip_pack(raw->data, config->snapshot + 6, 48);
+		}
+		else
+		{
+			status = SC14421_READ(1+memofs);
+			if (raw)
+			{
+				raw->status = status;
+				raw->rssi = SC14421_READ(memofs);
+			}
+
+			if (raw && ( (status & 0xc0) == 0xc0))
+				from_dip(raw->data, sc14421_base+memofs+6, 48);
+		}
+
+		if ( (status & 0xc0) == 0xc0) /* Checksum ok */
+			SC14421_WRITE(1+memofs, 0);	/* clear checksum flag */
+	}
+
+	if (half)
+	{
+		smp_wmb();
+		config->stage_head++;
+	}
+}
+
+/*
+ * COA_IOCTL_READ_BENCH: time reading the receive buffers of the running
+ * firmware's slots with both paths sniffer_stage_half() can take, in the
+ * same slot order. only reads, the checksum flags are left alone.
+ */
+int sniffer_read_bench(struct coa_info *dev, struct coa_read_bench *bench)
+{
+	volatile uint16_t *sc14421_base = dev->sc14421_base;
+	struct sniffer_cfg *config = dev->sniffer_config;
+	struct sc14421_fw *fw = dev->dip_fw;
+	unsigned char buf[SNIFF_BUF_LEN];
+	unsigned long flags;
+	ktime_t start;
+	u64 ns[2] = { 0, 0 };
+	unsigned int i;
+	int burst;
+	int a;
+
+	/* the scan firmware has no slot buffers in the RAM banks */
+	if (!config || !fw || !sc14421_base ||
+	    ( (config->snifftype != SNIFF_SYNC) &&
+	      (config->snifftype != SNIFF_RSSI) ))
+		return -EAGAIN;
+
+	if (!bench->slots)
+		bench->slots = COA_READ_BENCH_SLOTS;
+	if (bench->slots > COA_READ_BENCH_MAX)
+		return -EINVAL;
+
+	for (burst = 0; burst < 2; burst++)
+	{
+		for (i = 0; i < bench->slots; i++)
+		{
+			a = i % 24;
+
+			/* per buffer, so the irq handler isn't held off long */
+			spin_lock_irqsave(&dev->dip_lock, flags);
+			start = ktime_get();
 
+			SC14421_switch_to_bank(dev, fw->bank[a]);
+			if (burst)
+			{
+				from_dip_burst(config->snapshot, sc14421_base+fw->memofs[a], SNIFF_BUF_LEN);
+				from_dip_pack(buf, config->snapshot, SNIFF_BUF_LEN);
+			}
+			else
+				from_dip(buf, sc14421_base+fw->memofs[a], SNIFF_BUF_LEN);
+
+			ns[burst] += ktime_to_ns(ktime_sub(ktime_get(), start));
+			spin_unlock_irqrestore(&dev->dip_lock, flags);
+		}
+	}
+
+	do_div(ns[0], bench->slots);
+	do_div(ns[1], bench->slots);
+	bench->word_ns = ns[0];
+	bench->burst_ns = ns[1];
+	bench->burst = config->burst;
+
+	return 0;
+}
+
+void sniffer_sniff_sync_irq(struct coa_info *dev, int irq)
+{
+	volatile uint16_t *sc14421_base = dev->sc14421_base;
+	struct sniffer_cfg *config = dev->sniffer_config;
+	struct sniffed_packet packet;
+	int expected;
+	int slot;
+	int buf;
+#if 0
+	int i;	/* for the register dumps below */
+#endif
 
 	if (!(config->status & SNIFF_STATUS_FOUNDSTATION))
 	{
 		if (irq & 0x01)
 		{
+			SC14421_switch_to_bank(dev, SC14421_RAMBANK1);
 #if 0
 			printk("N:");
 			for (i=0; i<16; i++)
@@ -352,27 +961,16 @@ void sniffer_sniff_sync_irq(struct coa_info *dev, int irq)
 			{
 				SC14421_WRITE(1, 0); /* clear checksum flag */
 
-				from_dip(fppacket + 5,sc14421_base + 6, 6);
+				from_dip(config->rxbuf + 5,sc14421_base + 6, 6);
 
-				if (dect_compare_RFPI(fppacket, config->RFPI))
+				if (dect_compare_RFPI(config->rxbuf, config->RFPI))
 				{ 
 					printk("found station for sync\n");
 					config->status |= SNIFF_STATUS_FOUNDSTATION;
 
-					SC14421_switch_to_bank(sc14421_base,SC14421_CODEBANK);
-
-					switch(dev->radio_type)
-					{
-					case COA_RADIO_TYPE_II:
-						SC14421_write_cmd(sc14421_base, PPFoundII, BR, RecvNextII);
-						break;
-					case COA_RADIO_TYPE_III:
-						SC14421_write_cmd(sc14421_base, PPFoundIII, BR, RecvNextIII);
-						break;
-					default:
-						printk("ERROR: this radio type is currently not "
-								"supported. please update the driver\n");
-					}
+					SC14421_switch_to_bank(dev, SC14421_CODEBANK);
+					SC14421_write_cmd(sc14421_base, dev->dip_fw->pp_found,
+							  BR, dev->dip_fw->recv_next);
 				}
 			}
 		}
@@ -381,6 +979,7 @@ void sniffer_sniff_sync_irq(struct coa_info *dev, int irq)
 	{
 		if (irq & 0x01)
 		{
+			SC14421_switch_to_bank(dev, SC14421_RAMBANK1);
 
 #if 0
 			printk("S:");	
@@ -391,41 +990,40 @@ void sniffer_sniff_sync_irq(struct coa_info *dev, int irq)
 			if ( (SC14421_READ(1) & 0xc0) == 0xc0) /* Checksum ok */
 			{
 				SC14421_WRITE(1, 0); /* clear checksum flag */
-				from_dip(fppacket + 5, sc14421_base + 6, 48);
+				from_dip(config->rxbuf + 5, sc14421_base + 6, 48);
 
-				slot = dect_get_slot(fppacket);
-				if (slot != -1)
+				slot = dect_get_slot(config->rxbuf);
+				if ( (slot != -1) && ((slot % 12) == 11) )
+				{
+					/* the slot table can't receive it, keep
+					 * looking in case the beacon moves */
+					dev->stats.beacon_unusable++;
+					if (!(config->status & SNIFF_STATUS_BADSLOT))
+						printk("station in slot %u, not possible with this firmware\n", slot);
+					config->status |= SNIFF_STATUS_BADSLOT;
+				}
+				else if (slot != -1)
 				{
 					printk("station in slot %u\n", slot);
 					config->status |= SNIFF_STATUS_INSYNC;
+					config->status &= ~SNIFF_STATUS_BADSLOT;
 					slot %= 12;
-					if (slot%2)
-						printk("slot not possible with this firmware\n");
 
 					config->slottable[slot].active = 1;
 					config->slottable[slot].channel = config->channel;
 					config->slottable[slot].type = DECT_SLOTTYPE_CARRIER;
 					config->slottable[slot].errcnt = 0;
+					config->beacon = slot;
+					sniffer_update_slotmask(config);
 
 					sniffer_sync_patchloop(dev,config->slottable,SNIFF_SLOTPATCH_FP);
 					sniffer_sync_patchloop(dev,config->slottable,SNIFF_SLOTPATCH_PP);
 
-					SC14421_switch_to_bank(sc14421_base,SC14421_CODEBANK);
-
-					printk("set jump to %u\n",sync_jumptable[slot]);
+					SC14421_switch_to_bank(dev, SC14421_CODEBANK);
 
-					switch(dev->radio_type)
-					{
-					case COA_RADIO_TYPE_II:
-						SC14421_write_cmd(sc14421_base,PPFoundII,BR,sync_jumptable[slot]);
-						break;
-					case COA_RADIO_TYPE_III:
-						SC14421_write_cmd(sc14421_base,PPFoundIII,BR,sync_jumptable[slot]);
-						break;
-					default:
-						printk("ERROR: this radio type is currently not "
-								"supported. please update the driver\n");
-					}
+					printk("set jump to %u\n", dev->dip_fw->jump[slot]);
+					SC14421_write_cmd(sc14421_base, dev->dip_fw->pp_found,
+							  BR, dev->dip_fw->jump[slot]);
 
 					printk("we are in sync :)\n");
 
@@ -434,304 +1032,507 @@ void sniffer_sniff_sync_irq(struct coa_info *dev, int irq)
 					packet.rssi = SC14421_READ(0x00);
 					packet.channel = config->channel;
 					packet.slot = slot;
-					memcpy(packet.data, fppacket, 53);
-
-					packet.timestamp = dev->irq_timestamp;
-					ret = kfifo_put(dev->rx_fifo,(unsigned char*) &packet,sizeof(struct sniffed_packet));
-					if (ret <= 0)
-						printk("com_on_air_cs: rx fifo "
-							"full? kfifo_put() "
-							"= %d\n", ret);
+					memcpy(packet.data, config->rxbuf, 53);
+
+					sniffer_timestamp(&packet.timestamp, dev->irq_timestamp);
+					sniffer_queue(dev, COA_RECORD_PACKET,
+						&packet, sizeof(packet));
 				}
 			}
 		}
 	}
 	else
 	{
+		/* the frames take turns with the two receive buffers, both
+		 * halves of a frame use the same one. a half in the buffer
+		 * we didn't expect comes from a frame after the one we are
+		 * at: we are a whole frame late and the DIP has written
+		 * over what we would read, so it is dropped. */
+		buf = irq & SNIFF_IRQ_BUF_B;
+		expected = (config->expect_buf < 0) || (buf == config->expect_buf);
+		config->expect_buf = (irq & 0x08) ? (buf ^ SNIFF_IRQ_BUF_B) : buf;
+
 		if ( (irq & 0x09) == 0x09)
-			printk("com_on_air-cs: interrupt processing too slow , lost packets!\n");
+		{
+			/* we missed the first half, but the next frame runs
+			 * through the other slot table and leaves both halves
+			 * of this one alone */
+			dev->stats.overruns++;
+			if (expected)
+				dev->stats.recovered++;
+		}
+
+		if (!expected)
+		{
+			dev->stats.overrun_lost += !!(irq & 0x01) + !!(irq & 0x08);
+			return;
+		}
 
 		if (irq & 0x01)
+			sniffer_stage_half(dev, irq, 0);
+		if (irq & 0x08)
 		{
+			sniffer_stage_half(dev, irq, 12);
 
-			for (a=0; a<12; a++)
-			{
-				if (config->slottable[a].active)
-				{
-					SC14421_switch_to_bank(sc14421_base,sync_banktable[a]);
+			dev->stats.bank_switches_frame =
+				dev->stats.bank_switches - config->bank_mark;
+			config->bank_mark = dev->stats.bank_switches;
+		}
 
-					if ( (a/2) % 2)
-						memofs = 0x80;
-					else
-						memofs = 0x00;
+		tasklet_schedule(&dev->sniffer_tasklet);
+	}
+}
 
-#if 0
-						printk("F:");
-			        		for (i=0; i<16; i++)
-			        		        printk("%.2x ",(unsigned char) SC14421_READ(i+memofs));
+/*
+ * follow a call the station moves to another slot pair. the station
+ * announces the pair in the P channel, dect_update_slottable() has armed
+ * it by now and sniffer_rx_slots() puts it before the other carriers,
+ * so it is patched in with this half even if it neighbours the old one.
+ * the old pair is given up with the first good packet on the new one
+ * instead of after 32 errors. returns 1 if the slot table changed.
+ */
+static int sniffer_handover(struct coa_info *dev, int a, unsigned char *packet)
+{
+	struct sniffer_cfg *config = dev->sniffer_config;
+	int pair = a % 12;
+	int announced;
+	uint32_t last;
+	uint32_t lost;
+	int ret = 0;
+
+	announced = dect_other_bearer(packet);
+	if ( (announced >= 0) && (announced != config->bearer) )
+	{
+		if (config->ho_new < 0)
+			config->ho_old = config->bearer;
 
-			        		printk("  : %.2x : %x\n", irq, a);
-#endif
+		/* the first announcement is no handover, and going back
+		 * to the old pair calls it off */
+		if ( (config->ho_old < 0) || (announced == config->ho_old) )
+			config->ho_new = -1;
+		else
+		{
+			config->ho_new = announced;
+			config->ho_since = config->frame;
+		}
+		config->bearer = announced;
+	}
 
-					if ( (SC14421_READ(1+memofs) & 0xc0) == 0xc0) /* Checksum ok */
-					{
-						struct sniffed_packet packet;
-						packet.rssi = SC14421_READ(memofs);
-						packet.bfok = ((SC14421_READ(1+memofs) & 0x03) == 0x03);
-						packet.channel = config->slottable[a].channel;
-						packet.slot = a;
-						memcpy(packet.data,fppacket,5);
-
-						from_dip(&packet.data[5],sc14421_base+memofs+6,	48);
-
-						if (config->slottable[a].type == DECT_SLOTTYPE_SCAN)
-							/* we received data on a scan-slot,
-							 * channel is incemented before,
-							 * but we want hear the old channel */
-						{
-							packet.channel--;
-							//printk("slot in scanmode\n");
-						}
-
-						if (dect_is_multiframe_number(packet.data))
-							/* if there was a multiframe number,
-							 * then this packet was in frame 8 (0) */
-						{
-							//printk("found multiframe number\n");
-							config->framenumber = 1;
-						}
-
-						/* if (dev->open) */
-						{
-							if(config->framenumber)
-								packet.framenumber = config->framenumber-1;
-							else
-								packet.framenumber = 7;
-
-							packet.timestamp = dev->irq_timestamp;
-							ret = kfifo_put(dev->rx_fifo, (unsigned char*) &packet, sizeof(struct sniffed_packet));
-							if (ret <= 0)
-							{
-								printk("com_on_air_cs: rx fifo full? kfifo_put() = %d\n", ret);
-							}
-						}
+	if (pair == config->ho_new)
+	{
+		last = config->last_ok[config->ho_old];
+		if (last < config->ho_since - 1)
+			last = config->ho_since - 1;
+		lost = (config->frame > last) ? config->frame - last - 1 : 0;
 
+		dev->stats.handovers++;
+		dev->stats.handover_frames += lost;
+		if (lost > dev->stats.handover_max)
+			dev->stats.handover_max = lost;
 
+		if (config->ho_old != config->beacon)
+		{
+			dect_retire_bearer(config->slottable, config->ho_old);
+			ret = 1;
+		}
+		config->ho_new = -1;
+	}
 
-#if 0
-						printk("F:");
-			        		for (i=0; i<16; i++)
-			        		        printk("%.2x ", SC14421_READ(i+memofs));
+	config->last_ok[pair] = config->frame;
 
-			        		printk("  : %.2x : %x\n", irq, a);
-#endif
-						SC14421_WRITE(1+memofs, 0);	/* clear checksum flag */
-
-
-						if (dect_update_slottable(config->slottable, a, packet.data))
-						{
-							config->updateppslots = 1;
-							config->updatefpslots = 1;
-							//printk("new slot , must update slots\n");
-						}
-
-					}
-					else
-					{
-						if (dect_receive_error(config->slottable, a))
-						{
-							config->updateppslots = 1;
-							config->updatefpslots = 1;
-							//printk("1:died slot , must update slots\n");
-						}
-					}
-				}
-			}
+	return ret;
+}
 
-			if ( (!(irq & 0x08)) && (config->updatefpslots) )
-			{
-				//printk("patching fp slots\n");
-				sniffer_sync_patchloop(dev, config->slottable, SNIFF_SLOTPATCH_FP);
-				config->updatefpslots = 0;
-			}
+/*
+ * the primary receiver scan carrier of the frame starting at ts. the
+ * station steps it on by one every frame, so the last static system info
+ * tells it for any frame after it.
+ */
+static int sniffer_pscn(struct sniffer_cfg *config, s64 ts)
+{
+	u64 frames;
 
-		}
+	if (ts < config->pscn_ts)
+		return config->pscn;
 
-		if (irq & 0x08)
-		{
+	frames = ts - config->pscn_ts + DECT_FRAME_NS / 2;
+	do_div(frames, DECT_FRAME_NS);
 
-			for (a=12; a<24; a++)
-			{
-				if (config->slottable[a].active)
-				{
+	return (config->pscn + do_div(frames, DECT_SCAN_CARRIERS)) % DECT_SCAN_CARRIERS;
+}
 
-					SC14421_switch_to_bank(sc14421_base, sync_banktable[a]);
-
-					if ( (a/2) % 2)
-						memofs = 0x80;
-					else
-						memofs = 0x00;
-
-					if ( (SC14421_READ(1+memofs) & 0xc0) == 0xc0)		/* Checksum ok */
-					{
-						struct sniffed_packet packet;
-
-						packet.rssi = SC14421_READ(memofs);
-						packet.bfok = ((SC14421_READ(1+memofs) & 0x03) == 0x03);
-						packet.channel = config->slottable[a].channel;
-						packet.slot = a;
-						memcpy(packet.data, pppacket, 5);
-						from_dip(&packet.data[5], sc14421_base+memofs+6, 48);
-						if (config->slottable[a].type == DECT_SLOTTYPE_SCAN)
-						{
-							packet.channel--;
-							//printk("slot in scanmode\n");
-						}
-
-						/* if (dev->open) */
-						{
-							if(config->framenumber)
-								packet.framenumber = config->framenumber-1;
-							else
-								packet.framenumber = 7;
-
-							packet.timestamp = dev->irq_timestamp;
-							ret = kfifo_put(
-								dev->rx_fifo,
-								(unsigned char*) &packet,
-								sizeof(struct sniffed_packet));
-							if (ret <= 0)
-							{
-								printk("com_on_air_cs: rx fifo full? kfifo_put() = %d\n", ret);
-							}
-						}
+/*
+ * a handset sets a call up on the carrier the station scans in that
+ * frame, so scan slots listen there. the halves patched while the
+ * frame starting at frame_ts is handled are received in the frame after
+ * it, that one's carrier goes into the slot table. as long as there was
+ * no static system info the scan slots step on blindly, see
+ * dect_update_scanchannels(). also notes when a scan pair was armed.
+ * returns 1 if the slot table changed.
+ */
+static int sniffer_scan_carriers(struct coa_info *dev, s64 frame_ts)
+{
+	struct sniffer_cfg *config = dev->sniffer_config;
+	struct dect_slot_info *slottable = config->slottable;
+	int a;
 
+	for (a = 0; a < 12; a++)
+	{
+		if (!slottable[a].active)
+			config->setup_frame[a] = 0;
+		else if ( (slottable[a].type == DECT_SLOTTYPE_SCAN) &&
+			  !config->setup_frame[a] )
+			config->setup_frame[a] = config->frame;
+	}
 
-#if 0
-						printk("F:");
-			        		for (i=0; i<16; i++)
-			        		        printk("%.2x ", SC14421_READ(i+memofs));
+	if (config->pscn < 0)
+		return 0;
 
-			        		printk("  : %.2x : %x\n", irq, a);
-#endif
+	return dect_set_scanchannels(slottable,
+			sniffer_pscn(config, frame_ts + DECT_FRAME_NS));
+}
 
-						SC14421_WRITE(1+memofs, 0);	/* clear checksum flag */
+/* the first B-field on a pair armed for scanning ends its call setup */
+static void sniffer_call_setup(struct coa_info *dev, int a, unsigned char *packet)
+{
+	struct sniffer_cfg *config = dev->sniffer_config;
+	uint32_t frames;
 
+	if (!config->setup_frame[a % 12] || !dect_has_b_field(packet))
+		return;
 
-						if (dect_update_slottable(config->slottable, a, packet.data))
-						{
-							config->updateppslots = 1;
-							config->updatefpslots = 1;
-							//printk("new slot , must update slots\n"); 
-						}
+	frames = config->frame - config->setup_frame[a % 12];
+	config->setup_frame[a % 12] = 0;
 
-					}
-					else
-					{
-						if (dect_receive_error(config->slottable, a))
-						{
-							config->updateppslots = 1;
-							config->updatefpslots = 1;
-							//printk("8:died slot , must update slots\n"); 
-						}
-					}
+	dev->stats.call_setups++;
+	dev->stats.setup_frames += frames;
+	if (frames > dev->stats.setup_max)
+		dev->stats.setup_max = frames;
+}
 
-				}
+/*
+ * bottom half of the sync sniffer: everything that does not need the
+ * DIP memory - building packets, MAC layer parsing, slot table updates
+ * and deciding when the firmware has to be patched.
+ */
+static void sniffer_sync_half(struct coa_info *dev, struct sniffer_half *half, int late)
+{
+	struct sniffer_cfg *config = dev->sniffer_config;
+	struct sniffer_raw_slot *raw;
+	struct sniffed_packet packet;
+	unsigned long flags;
+	int first = half->first;
+	int update;
+	int pscn;
+	int a;
 
+	if ( (half->irq & 0x09) != 0x09)
+		sniffer_update_frame_ts(dev, first + 12, half->timestamp);
+
+	for (a = first; a < (first + 12); a++)
+	{
+		raw = &half->slot[a - first];
+		if (!raw->active)
+			continue;
+
+		if ( (raw->status & 0xc0) == 0xc0) /* Checksum ok */
+		{
+			dev->stats.slot_ok[a]++;
+
+			packet.rssi = raw->rssi;
+			packet.bfok = ((raw->status & 0x03) == 0x03);
+			packet.channel = config->slottable[a].channel;
+			packet.slot = a;
+			if (first)
+				memcpy(packet.data, pppacket, 5);
+			else
+				memcpy(packet.data, fppacket, 5);
+			memcpy(&packet.data[5], raw->data, 48);
+
+			if (config->slottable[a].type == DECT_SLOTTYPE_SCAN)
+				/* we received data on a scan-slot,
+				 * channel is incemented before,
+				 * but we want hear the old channel */
+			{
+				if (packet.channel == 0)
+					packet.channel = DECT_SCAN_CARRIERS - 1;
+				else
+					packet.channel--;
+				//printk("slot in scanmode\n");
 			}
 
-			if ( (!(irq & 0x01)) && (config->updateppslots) )
+			if (!first && dect_is_multiframe_number(packet.data))
+				/* if there was a multiframe number,
+				 * then this packet was in frame 8 (0) */
 			{
-				//printk("patching pp slots\n");
-				sniffer_sync_patchloop(dev, config->slottable, SNIFF_SLOTPATCH_PP);
-				config->updateppslots = 0;
+				//printk("found multiframe number\n");
+				config->framenumber = 1;
 			}
 
-			if (dect_update_scanchannels(config->slottable))
+			if (sniffer_filter_accept(&dev->filter, &packet))
+			{
+				if(config->framenumber)
+					packet.framenumber = config->framenumber-1;
+				else
+					packet.framenumber = 7;
+
+				sniffer_timestamp(&packet.timestamp, sniffer_slot_ts(dev, a));
+				sniffer_queue(dev, COA_RECORD_PACKET, &packet, sizeof(packet));
+			}
+			else
+				dev->stats.filtered++;
+
+			if (dect_update_slottable(config->slottable, a, packet.data))
 			{
 				config->updateppslots = 1;
 				config->updatefpslots = 1;
 				//printk("new slot , must update slots\n");
 			}
 
-			if (config->framenumber >= 7)
-				config->framenumber = 0;
-			else
-				config->framenumber++;
+			if (sniffer_handover(dev, a, packet.data))
+			{
+				config->updateppslots = 1;
+				config->updatefpslots = 1;
+			}
+
+			pscn = dect_get_pscn(packet.data);
+			if (pscn >= 0)
+			{
+				/* that is the carrier of the next frame */
+				config->pscn = pscn;
+				config->pscn_ts = config->frame_ts + DECT_FRAME_NS;
+			}
+
+			sniffer_call_setup(dev, a, packet.data);
 		}
+		else
+		{
+			dev->stats.slot_err[a]++;
+			if (dect_receive_error(config->slottable, a))
+			{
+				dev->stats.slot_deaths++;
+				config->updateppslots = 1;
+				config->updatefpslots = 1;
+				//printk("died slot , must update slots\n");
+			}
+		}
+	}
+
+	if (sniffer_scan_carriers(dev, config->frame_ts))
+	{
+		config->updateppslots = 1;
+		config->updatefpslots = 1;
+	}
+
+	/* the new pair died before it showed up, follow the old one again */
+	if ( (config->ho_new >= 0) && !config->slottable[config->ho_new].active)
+	{
+		config->bearer = config->ho_old;
+		config->ho_new = -1;
+	}
+
+	sniffer_update_slotmask(config);
+
+	/* only patch a half while the DIP is busy with the other one. if
+	 * we are running late the flag stays set and the next half retries */
+	if (!first)
+	{
+		if ( (!(half->irq & 0x08)) && (config->updatefpslots) && !late)
+		{
+			//printk("patching fp slots\n");
+			spin_lock_irqsave(&dev->dip_lock, flags);
+			sniffer_sync_patchloop(dev, config->slottable, SNIFF_SLOTPATCH_FP);
+			spin_unlock_irqrestore(&dev->dip_lock, flags);
+			config->updatefpslots = 0;
+		}
+	}
+	else
+	{
+		if ( (!(half->irq & 0x01)) && (config->updateppslots) && !late)
+		{
+			//printk("patching pp slots\n");
+			spin_lock_irqsave(&dev->dip_lock, flags);
+			sniffer_sync_patchloop(dev, config->slottable, SNIFF_SLOTPATCH_PP);
+			spin_unlock_irqrestore(&dev->dip_lock, flags);
+			config->updateppslots = 0;
+		}
+
+		/* from here on the halves of the next frame are patched */
+		if (config->pscn >= 0)
+			update = dect_set_scanchannels(config->slottable,
+					sniffer_pscn(config, config->frame_ts + 2 * DECT_FRAME_NS));
+		else
+			update = dect_update_scanchannels(config->slottable);
+		if (update)
+		{
+			config->updateppslots = 1;
+			config->updatefpslots = 1;
+			//printk("new slot , must update slots\n");
+		}
+
+		if (config->framenumber >= 7)
+			config->framenumber = 0;
+		else
+			config->framenumber++;
+		config->frame++;
+
+		config->frame_ts += DECT_FRAME_NS;
+	}
+}
+
+void sniffer_tasklet(unsigned long data)
+{
+	struct coa_info *dev = (struct coa_info *) data;
+	struct sniffer_cfg *config = dev->sniffer_config;
+	struct sniffer_half *half;
+	int late;
+
+	if (!config)
+		return;
+
+	while (config->stage_tail != config->stage_head)
+	{
+		smp_rmb();
+		half = &config->stage[config->stage_tail % SNIFFER_STAGE_DEPTH];
+		late = (config->stage_head - config->stage_tail) > 1;
+
+		sniffer_sync_half(dev, half, late);
 
+		smp_mb();
+		config->stage_tail++;
 	}
+
+	coa_rx_wakeup(dev);
 }
 
 
-void sniffer_sync_patchloop(struct coa_info *dev, struct dect_slot_info *slottable, int type)
+/*
+ * the slots of one half frame the firmware receives. a receive needs the
+ * slot before it to set up the radio, so of two neighbouring slots only
+ * one can be received: the beacon we synced on goes first, then a pair
+ * the call is being handed over to, then known carriers, scan slots
+ * take what is left. the last slot of a half is never received, the slot after it
+ * belongs to the other half and is patched at another time.
+ */
+static uint32_t sniffer_rx_slots(struct sniffer_cfg *config, int first)
 {
-	static int fixme_count = 23;
+	struct dect_slot_info *slottable = config->slottable;
+	uint32_t rx = 0;
+	int rank;
+	int pass;
+	int a;
 
+	for (pass = 0; pass < 4; pass++)
+	{
+		for (a = first; a < (first + 11); a++)
+		{
+			/* pinned slots only, see COA_IOCTL_SLOT */
+			if (!slottable[a].active || !(config->slotmask & (1 << a)))
+				continue;
+
+			if ( (a % 12) == config->beacon)
+				rank = 0;
+			else if ( (a % 12) == config->ho_new)
+				rank = 1;
+			else if (slottable[a].type == DECT_SLOTTYPE_CARRIER)
+				rank = 2;
+			else
+				rank = 3;
+			if (rank != pass)
+				continue;
+
+			if ( (a > first) && (rx & (1 << (a - 1))) )
+				continue;
+			if (rx & (1 << (a + 1)))
+				continue;
+
+			rx |= 1 << a;
+		}
+	}
+
+	return rx;
+}
+
+void sniffer_sync_patchloop(struct coa_info *dev, struct dect_slot_info *slottable, int type)
+{
 	int slot, offset = 0;
 	volatile uint16_t *sc14421_base = dev->sc14421_base;
 	struct sniffer_cfg *config = dev->sniffer_config;
+	struct sc14421_fw *fw = dev->dip_fw;
 	int memofs;
+	uint32_t half, rx, changed;
+	/* code patches, applied after all RAM bank writes so that we
+	 * switch to the code bank only once */
+	unsigned char patch[12];
+	int patches = 0;
+
+	dev->stats.patchloops++;
 
 	if (type == SNIFF_SLOTPATCH_PP)
 		offset = 12;
 
+	half = 0xfff << offset;
+	rx = sniffer_rx_slots(config, offset);
+
+	/* a slot changes, and so does the one after it */
+	changed = (rx ^ config->rxmask) & half;
+	changed = (changed | (changed << 1)) & half;
+	config->rxmask = (config->rxmask & ~half) | rx;
+
+	memset(patch, SNIFF_PATCH_NONE, sizeof(patch));
+
 	for (slot = offset; slot < (offset+12); slot++)
 	{
+		memofs = fw->memofs[slot];
 
-		if ( (slot/2) % 2)
-			memofs = 0x80;
-		else
-			memofs = 0x00;
-
-		if (slottable[slot].update)
+		if (slottable[slot].update || (changed & (1 << slot)))
 		{
 			slottable[slot].update = 0;
 
-			if (slottable[slot].active && (slot%2))
-			{
-				if (fixme_count)
-				{
-					fixme_count--;
-					printk("can't use slot %u with this firmware !\n", slot);
-				}
-				continue;
-			}
-
-
-			if (slottable[slot].active)
+			if (rx & (1 << slot))
 			{
 
-				set_channel(dev,slottable[slot].channel,slot,config->framenumber%8,0,sync_banktable[slot]);
-
-				// printk("patching slot %u at addr %u\n", slot, sync_patchtable[slot]);
-				SC14421_switch_to_bank(sc14421_base, SC14421_CODEBANK);
-
-				switch(dev->radio_type)
-				{
-				case COA_RADIO_TYPE_II:
-					/* printk(" for type II\n"); */
-					SC14421_write_cmd(sc14421_base, sync_patchtable[slot], JMP, RecvII);
-					break;
-				case COA_RADIO_TYPE_III:
-					/* printk(" for type III\n"); */
-					SC14421_write_cmd(sc14421_base, sync_patchtable[slot], JMP, RecvIII);
-					break;
-				default:
-					printk("ERROR: this radio type is currently not "
-						"supported. please update the driver\n");
-				}
+				set_channel(dev,slottable[slot].channel,slot,config->framenumber%8,0,fw->bank[slot]);
+				patch[slot - offset] = SNIFF_PATCH_RECV;
 
+			}else if ( (slot > offset) && (rx & (1 << (slot - 1))) ){
+				patch[slot - offset] = SNIFF_PATCH_SKIP;
 			}else{
-				SC14421_switch_to_bank(sc14421_base, SC14421_CODEBANK);
-				SC14421_write_cmd(sc14421_base, sync_patchtable[slot], WNT, 2);
-				// printk("patching addr %u for wait\n", sync_patchtable[slot]);
+				patch[slot - offset] = SNIFF_PATCH_WAIT;
 			}
+			patches++;
 		}
-		else if (slottable[slot].active && (slottable[slot].type == DECT_SLOTTYPE_CARRIER))
+		else if ( (rx & (1 << slot)) && (slottable[slot].type == DECT_SLOTTYPE_CARRIER) )
+		{
+			SC14421_switch_to_bank(dev, fw->bank[slot]);
+			SC14421_WRITE(SNIFF_MODE + 6 + memofs, config->framenumber%8);
+		}
+	}
+
+	if (!patches)
+		return;
+
+	SC14421_switch_to_bank(dev, SC14421_CODEBANK);
+
+	for (slot = offset; slot < (offset+12); slot++)
+	{
+		switch (patch[slot - offset])
 		{
-			SC14421_switch_to_bank(sc14421_base, sync_banktable[slot]);
-			SC14421_WRITE(0x5e + memofs, config->framenumber%8);
+		case SNIFF_PATCH_RECV:
+			// printk("patching slot %u at addr %u\n", slot, fw->patch[slot]);
+			SC14421_write_cmd(sc14421_base, fw->patch[slot], JMP, fw->recv);
+			SC14421_write_cmd(sc14421_base, fw->patch_b[slot], JMP, fw->recv_b);
+			break;
+		case SNIFF_PATCH_WAIT:
+			SC14421_write_cmd(sc14421_base, fw->patch[slot], WNT, 1);
+			SC14421_write_cmd(sc14421_base, fw->patch_b[slot], WNT, 1);
+			// printk("patching addr %u for wait\n", fw->patch[slot]);
+			break;
+		case SNIFF_PATCH_SKIP:
+			/* the receive before already waited into the next slot */
+			SC14421_write_cmd(sc14421_base, fw->patch[slot], WT, 1);
+			SC14421_write_cmd(sc14421_base, fw->patch_b[slot], WT, 1);
+			break;
 		}
 	}
 }
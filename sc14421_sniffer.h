@@ -19,26 +19,137 @@
 #define SNIFF_SCANFP	COA_SUBMODE_SNIFF_SCANFP
 #define SNIFF_SCANPP	COA_SUBMODE_SNIFF_SCANPP
 #define SNIFF_SYNC	COA_SUBMODE_SNIFF_SYNC
+#define SNIFF_RSSI	COA_SUBMODE_SNIFF_RSSI
 
 #define SNIFF_STATUS_FOUNDSTATION	0x80
 #define SNIFF_STATUS_INSYNC		0x40
+#define SNIFF_STATUS_BADSLOT		0x20	/* beacon in slot 11 or 23 */
 
 #define SNIFF_SLOTPATCH_FP	0
 #define SNIFF_SLOTPATCH_PP	1
 
+/* what sniffer_sync_patchloop() writes into a slot's code */
+#define SNIFF_PATCH_NONE	0
+#define SNIFF_PATCH_RECV	1
+#define SNIFF_PATCH_WAIT	2
+#define SNIFF_PATCH_SKIP	3	/* the slot before is received */
+
+/* a slot's 128 bytes of DIP RAM with the sync firmware. the frames
+ * alternate between two receive buffers, see SlotTable in the firmware */
+#define SNIFF_BUF_A		0x00	/* frames through SlotTable */
+#define SNIFF_BUF_B		0x36	/* frames through SlotTableB */
+#define SNIFF_BUF_LEN		0x36	/* rssi, status, 4 words, 48 bytes */
+#define SNIFF_RADIO		0x6C
+#define SNIFF_DIPREG		0x72
+#define SNIFF_MODE		0x79
+
+/* added to both interrupts of a SlotTableB frame */
+#define SNIFF_IRQ_BUF_B		0x04
+
+/* the radio register at SNIFF_RADIO */
+#define SNIFF_RADIO_LEN		6
+
 #include "dect.h"
 #include "com_on_air.h"
 
+/* raw copy of one slot, taken by the interrupt handler */
+struct sniffer_raw_slot
+{
+	unsigned char		active;	/* slot was active when staged */
+	unsigned char		status;	/* DIP word 1, checksum flags */
+	unsigned char		rssi;
+	unsigned char		data[48];
+};
+
+/* one half frame, slots 0-11 (irq 0x01) or 12-23 (irq 0x08) */
+struct sniffer_half
+{
+	int			irq;
+	int			first;
+	s64			timestamp;	/* ns, irq entry */
+	struct sniffer_raw_slot	slot[12];
+};
+
+/* an RFPI heard in an aggregated scan, see COA_IOCTL_SCANAGG */
+struct sniffer_station
+{
+	unsigned char		used;
+	unsigned char		channel;
+	unsigned char		RFPI[5];
+	unsigned char		rssi_min;
+	unsigned char		rssi_max;
+	uint16_t		count;		/* since the last record */
+	uint32_t		rssi_sum;
+	s64			first_seen;	/* ns */
+	s64			last_seen;
+};
+
+/* half frames the tasklet may lag behind the interrupt */
+#define SNIFFER_STAGE_DEPTH	4
+
 struct sniffer_cfg
 {
 	int			snifftype;
 	int			channel;
 	unsigned char		RFPI[5];
 	unsigned char		status;
+	unsigned char		rxbuf[53];	/* fppacket + what the irq read */
 	struct dect_slot_info	slottable[24];
 	int			framenumber;
+	s64			frame_ts;	/* ns, start of slot 0 */
 	int			updatefpslots;
 	int			updateppslots;
+
+	/* COA_IOCTL_SLOT */
+	int			pinned;		/* slot pair 0..11, -1: none */
+	int			beacon;		/* slot we synced on, -1: none */
+	uint32_t		slotmask;	/* bit n: slot n may be received */
+	uint32_t		rxmask;		/* bit n: slot n is received */
+
+	/* bearer handover, see sniffer_handover() */
+	int			bearer;		/* pair the call is announced on, -1: none */
+	int			ho_old;		/* pair being replaced */
+	int			ho_new;		/* pair announced, no packet yet, -1: none */
+	uint32_t		ho_since;	/* frame of the announcement */
+	uint32_t		frame;		/* frames since sync, from 1 on */
+	uint32_t		last_ok[12];	/* frame of a pair's last good packet */
+
+	/* primary receiver scan carrier, see sniffer_pscn() */
+	int			pscn;		/* carrier at pscn_ts, -1: not seen */
+	s64			pscn_ts;	/* ns, start of that frame */
+	uint32_t		setup_frame[12]; /* frame a scan pair was armed, 0: none */
+
+	/* top half -> tasklet, single producer / single consumer */
+	struct sniffer_half	stage[SNIFFER_STAGE_DEPTH];
+	unsigned int		stage_head;
+	unsigned int		stage_tail;
+
+	uint32_t		bank_mark;	/* stats.bank_switches at frame start */
+	int			expect_buf;	/* SNIFF_IRQ_BUF_B of the next half, -1: any */
+	int			burst;		/* read slots with from_dip_burst() */
+	uint16_t		snapshot[SNIFF_BUF_LEN];
+
+	/* rssi sweep */
+	uint32_t		rssi_carriers;	/* bitmask, see COA_IOCTL_RSSI */
+	unsigned char		rssi_list[COA_RSSI_MAX_CARRIERS];
+	int			rssi_count;
+	int			rssi_index;	/* carrier being measured */
+	int			rssi_odd;	/* on its odd slots */
+	int			rssi_primed;	/* a whole frame on rssi_index */
+	struct coa_rssi_row	rssi_row;
+
+	/* aggregated scan, open addressing on RFPI and channel */
+	struct sniffer_station	scan_table[COA_SCAN_MAX_STATIONS];
+	s64			scan_summary_ts;	/* ns, last summary */
+};
+
+/* what tells the radio types apart, dev->radio is set at probe time */
+struct sniffer_radio
+{
+	unsigned int		type;		/* COA_RADIO_TYPE_*, the firmware */
+	unsigned char		reg[SNIFF_RADIO_LEN];	/* template */
+	unsigned char		mode;		/* or'ed into the DIP mode */
+	void			(*tune)(unsigned char *reg, int channel);
 };
 
 struct sniffed_rfpi
@@ -48,29 +159,30 @@ struct sniffed_rfpi
 	unsigned char RFPI[5];
 };
 
+/* DECT frame timing */
+#define DECT_FRAME_NS		10000000LL
+#define DECT_SLOT_NS		(DECT_FRAME_NS / 24)
+
 #define SLOT_OUT_OF_SYNC  0x20
 #define SLOT_IN_SYNC      0x21
 
-struct sniffed_packet
-{
-	unsigned char     rssi;
-	unsigned char     channel;
-	unsigned char     slot;
-	unsigned char     framenumber;
-	unsigned char     bfok;
-	struct timespec   timestamp;
-	unsigned char     data[53];
-};
-
 
+const struct sniffer_radio *sniffer_radio(unsigned int radio_type);
 void    sniffer_init(struct coa_info *dev);
 void    sniffer_init_sniff_all(struct coa_info *dev);
-void    sniffer_init_sniff_scan(struct coa_info *dev);
-void    sniffer_init_sniff_sync(struct coa_info *dev);
+void    sniffer_init_sniff_scan(struct coa_info *dev, struct sc14421_fw *fw);
+void    sniffer_init_sniff_sync(struct coa_info *dev, struct sc14421_fw *fw);
+void    sniffer_init_sniff_rssi(struct coa_info *dev, struct sc14421_fw *fw);
+int     sniffer_retune(struct coa_info *dev);
+void    sniffer_pin_slot(struct coa_info *dev, uint32_t slot);
+void    sniffer_scan_reset(struct coa_info *dev);
+int     sniffer_read_bench(struct coa_info *dev, struct coa_read_bench *bench);
 uint8_t sniffer_irq_handler(struct coa_info *dev);
 void    sniffer_sniff_all_irq(struct coa_info *dev,int irq);
 void    sniffer_sniff_scan_irq(struct coa_info *dev,int irq);
 void    sniffer_sniff_sync_irq(struct coa_info *dev,int irq);
+void    sniffer_sniff_rssi_irq(struct coa_info *dev,int irq);
+void    sniffer_tasklet(unsigned long data);
 void    sniffer_sync_patchloop(struct coa_info *dev,struct dect_slot_info *slottable,int type);
 void    sniffer_clear_slottable(struct dect_slot_info *slottable);
 #endif
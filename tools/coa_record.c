@@ -0,0 +1,131 @@
+/*
+ * coa_record archives the raw sync sniff records of a given channel and RFPI
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * authors:
+ * (C) 2008  Andreas Schuler <krater at badterrorist dot com>
+ * (C) 2008  Matthias Wenzel <dect at mazzoo dot de>
+ *
+ */
+
+/*
+ * the records never pass through userspace: they are splice()d from
+ * /dev/coa into a pipe and from there into the output file. the file is
+ * a plain sequence of struct sniffed_packet, see com_on_air_user.h.
+ */
+
+#define _GNU_SOURCE
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#include "com_on_air_user.h"
+
+#define DEV "/dev/coa"
+
+/* default RFPI */
+uint8_t RFPI[5]={0x00,0x00,0x00,0x00,0x00};
+
+
+int main(int argc, char *argv[])
+{
+	int d, out;
+	int p[2];
+	ssize_t ret, n;
+	unsigned long long total = 0;
+	const char *dev = getenv("COA_DEV"); /* e.g. /dev/coa1 */
+
+	if(argc<3)
+	{
+		printf(	"Usage:coa_record channel record-file [RFPI]\n");
+		exit(-1);
+	}
+
+	if (!dev)
+		dev = DEV;
+
+	d=open(dev, O_RDONLY);
+	if (d<0)
+	{
+		printf("couldn't open(\"%s\"): %s\n", dev, strerror(errno));
+		exit(1);
+	}
+
+	out=open(argv[2], O_WRONLY|O_CREAT|O_TRUNC, 0644);
+	if (out<0)
+	{
+		printf("couldn't open(\"%s\"): %s\n", argv[2], strerror(errno));
+		exit(1);
+	}
+
+	if (pipe(p))
+	{
+		printf("couldn't pipe(): %s\n", strerror(errno));
+		exit(1);
+	}
+
+	if(argc>3)
+	{
+		sscanf(argv[3], "%hhx %hhx %hhx %hhx %hhx", &RFPI[0], &RFPI[1], &RFPI[2], &RFPI[3], &RFPI[4]);
+		printf("RFPI: %02x %02x %02x %02x %02x\n", RFPI[0], RFPI[1], RFPI[2], RFPI[3], RFPI[4]);
+	}
+
+	//set sync sniff mode
+	uint16_t val;
+	val = COA_MODE_SNIFF|COA_SUBMODE_SNIFF_SYNC;
+	if(ioctl(d,COA_IOCTL_MODE, &val)){printf("couldn't ioctl()\n");exit(1);}
+
+	//set rfpi to sync with
+	if(ioctl(d,COA_IOCTL_SETRFPI, RFPI)){printf("couldn't ioctl()\n");exit(1);}
+
+	//set channel
+	uint32_t chn=atoi(argv[1]);
+	printf("set channel %u\n",chn);
+	if(ioctl(d,COA_IOCTL_CHAN,&chn)){printf("couldn't set channel\n");exit(1);}
+
+	//wake up a few times per second, each splice() moves whole pages
+	struct coa_watermark wm={60,250000};
+	if(ioctl(d,COA_IOCTL_WATERMARK,&wm)){printf("couldn't set watermark\n");exit(1);}
+
+	//record-loop
+	while (0xDEC + 't')
+	{
+		ret = splice(d, NULL, p[1], NULL, 1 << 16, SPLICE_F_MOVE);
+		if (ret < 0)
+		{
+			if ((errno == EINTR) || (errno == EAGAIN))
+				continue;
+			printf("couldn't splice() from %s: %s\n", dev, strerror(errno));
+			break;
+		}
+
+		while (ret > 0)
+		{
+			n = splice(p[0], NULL, out, NULL, ret, SPLICE_F_MOVE);
+			if (n < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				printf("couldn't splice() to %s: %s\n", argv[2], strerror(errno));
+				exit(1);
+			}
+			ret -= n;
+			total += n;
+		}
+
+		printf("\r%llu packets", total / sizeof(struct sniffed_packet));
+		fflush(stdout);
+	}
+
+	return 1;
+}
@@ -0,0 +1,604 @@
+/*
+ * coa_sim - run the com_on_air_cs sniffer on a simulated SC14421
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * authors:
+ * (C) 2008  Andreas Schuler <krater at badterrorist dot com>
+ * (C) 2008  Matthias Wenzel <dect at mazzoo dot de>
+ *
+ */
+
+/*
+ * drives the driver's sync sniffer (sniffer_irq_handler(), the tasklet,
+ * the patchloop and the dect_* helpers) with a scripted base station:
+ * a dummy bearer on one slot and optionally a call on a traffic slot.
+ * prints how long the interrupt handler and the tasklet took.
+ * odd frames run through the firmware's second slot table and buffers,
+ * with -l some of the first half interrupts come late.
+ * with -w the rssi sweep runs instead and the harness prints where it
+ * found the station.
+ * with -d the firmware itself runs on the DIP emulator in sc14421_dip.c
+ * instead of the harness filling in the buffers, the interrupts come
+ * when the firmware raises them and the emulator prints what each slot
+ * costs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "com_on_air.h"
+#include "sc14421.h"
+#include "sc14421_sniffer.h"
+#include "sc14421_loader.h"
+#include "sc14421_sim.h"
+#include "sc14421_dip.h"
+
+static struct sc14421_sim sim;
+static struct coa_info dev;
+static struct sniffer_cfg config;
+static struct coa_ring_reader reader;
+
+/* the scripted station */
+static struct
+{
+	uint8_t		RFPI[5];
+	int		channel;
+	int		slot;		/* dummy bearer, 0..11 */
+	int		traffic;	/* call on traffic / traffic+12, -1: none */
+	int		errors;		/* percent of slots received broken */
+	int		late;		/* percent of frames with a late irq */
+	int		frame_late;	/* percent of frames with both irqs late */
+	int		handover;	/* move the call every n frames, 0: never */
+	int		old;		/* pair the call left, still sent on */
+	int		old_until;	/* up to this frame */
+	int		setup;		/* the call starts in this frame, 0: up already */
+	int		call_carrier;	/* the scan carrier of that frame */
+} station = { {0x00, 0x12, 0x34, 0x56, 0x78}, 5, 0, -1, 0, 0, 0, 0, -1, 0, 0, 0 };
+
+struct timing
+{
+	unsigned long	n;
+	uint64_t	sum;
+	uint64_t	max;
+};
+
+static struct timing t_irq, t_bh;
+
+static int sweep;
+static int emulate;
+static struct sc14421_dip dip;
+static struct coa_rssi_row rssi_map[COA_RSSI_MAX_CARRIERS];
+
+/* the interrupt handler in com_on_air.c would wake readers here */
+void coa_rx_wakeup(struct coa_info *dev)
+{
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void timing_add(struct timing *t, uint64_t ns)
+{
+	t->n++;
+	t->sum += ns;
+	if (ns > t->max)
+		t->max = ns;
+}
+
+static void timing_print(const char *name, struct timing *t)
+{
+	printf("%-10s %8lu runs  avg %7llu ns  max %7llu ns\n", name, t->n,
+		(unsigned long long) (t->n ? t->sum / t->n : 0),
+		(unsigned long long) t->max);
+}
+
+/*
+ * with -H the call moves to another pair every station.handover frames
+ * and is still sent on the old pair for two more frames, the way a
+ * handset hands over: the new bearer is up before the old one is gone
+ */
+static void station_frame(int frame)
+{
+	static int moved;
+	int t;
+
+	if (!station.handover || (station.traffic < 0) ||
+	    (frame < moved + station.handover))
+		return;
+	moved = frame;
+
+	t = station.traffic;
+	do
+		t = (t + 5) % 12;
+	while ( (t == 11) || (abs(t - station.slot) <= 1) );
+
+	station.old = station.traffic;
+	station.old_until = frame + 2;
+	station.traffic = t;
+}
+
+/* does the call use slot pair in this frame */
+static int station_bearer(int pair, int frame)
+{
+	if (station.setup && (frame < station.setup))
+		return 0;
+	return (pair == station.traffic) ||
+	       ((pair == station.old) && (frame < station.old_until));
+}
+
+/* the carrier the station's primary receiver scans in a frame */
+static int station_pscn(int frame)
+{
+	return (frame + 7) % DECT_SCAN_CARRIERS;
+}
+
+/* the carrier of slot a. with -C the handset sets the call up on the
+ * scan carrier of that frame, the station stays on its own */
+static int station_carrier(int a)
+{
+	if (station.setup && ((a % 12) == station.traffic))
+		return station.call_carrier;
+	return station.channel;
+}
+
+/*
+ * the 48 bytes the DIP stores from word 6 on: A-field header and tail,
+ * A-field crc, B-field. frame is the frame number since start.
+ */
+static void build_packet(uint8_t *data, int frame, int fp, int bfield)
+{
+	int mf = frame % 16;
+	uint8_t ba = bfield ? 0x00 : 0x0e;
+	int i;
+
+	memset(data, 0, 48);
+
+	if (fp && (mf == 8))
+	{
+		/* Q channel: static system info or multiframe number */
+		data[0] = 0x80 | ba;
+		if ((frame / 16) % 2)
+			data[1] = 0x60;
+		else
+		{
+			data[1] = 0x00 | station.slot;
+			data[5] = station.setup ? station_pscn(frame + 1) : station.channel;
+		}
+	}
+	else if (fp && (mf % 2) && station.setup && (frame >= station.setup - 4))
+	{
+		/* P channel: blind full slot information, the pair the
+		 * handset is about to set its call up on */
+		unsigned int blind = 0x800 >> station.traffic;
+
+		data[0] = 0xe0 | ba;
+		data[1] = 0x00;
+		data[4] = 0x10 | (blind >> 8);
+		data[5] = blind & 0xff;
+	}
+	else if (fp && (mf % 2) && (station.traffic >= 0) && !station.setup)
+	{
+		/* P channel: zero length page announcing the call bearer */
+		data[0] = 0xe0 | ba;
+		data[1] = 0x00;
+		data[4] = 0x20 | station.traffic;
+		data[5] = station.channel;
+	}
+	else
+	{
+		/* N channel: the identity */
+		data[0] = 0x60 | ba;
+		memcpy(&data[1], station.RFPI, 5);
+	}
+
+	for (i = 8; i < 48; i++)
+		data[i] = frame + i;
+}
+
+/* the carrier set_channel() programmed for slot a, type II radio */
+static int dip_carrier(int a)
+{
+	int memofs = dev.dip_fw->memofs[a];
+	int channel = (sim_dip_read(&sim, dev.dip_fw->bank[a], memofs + SNIFF_RADIO) >> 1) & 0x1f;
+
+	return (channel <= 10) ? 10 - channel : channel;
+}
+
+/* what the firmware would have received in slot a of this frame */
+static void dip_receive(int frame, int a, unsigned char bank, int memofs)
+{
+	int fp = a < 12;
+	int bfield = station_bearer(a % 12, frame);
+	uint8_t data[48];
+	int i;
+
+	if ( ((a % 12) != station.slot) && !bfield)
+		return;
+	if (!fp && !bfield)
+		return;		/* dummy bearers are simplex */
+	if (bfield && station.setup && (dip_carrier(a) != station.call_carrier))
+		return;
+
+	if (station.errors && ((rand() % 100) < station.errors))
+	{
+		sim_dip_write(&sim, bank, memofs + 1, 0x00);
+		return;
+	}
+
+	build_packet(data, frame, fp, bfield);
+
+	sim_dip_write(&sim, bank, memofs + 0, 0x40 + (frame % 32));
+	sim_dip_write(&sim, bank, memofs + 1, 0xc0 | (bfield ? 0x03 : 0x00));
+	for (i = 0; i < 48; i++)
+		sim_dip_write(&sim, bank, memofs + 6 + i, data[i]);
+}
+
+/* the sweep: every slot but 11 and 23 stores the rssi of the carrier
+ * it is on. the driver reads the ones it received on this frame */
+static void dip_half_rssi(int frame, int first, int buf)
+{
+	int a;
+
+	for (a = first; a < (first + 11); a++)
+	{
+		int busy = (dip_carrier(a) == station.channel) &&
+			   ( ((a % 12) == station.slot) ||
+			     station_bearer(a % 12, frame) );
+		int memofs = dev.dip_fw->memofs[a] + buf;
+
+		sim_dip_write(&sim, dev.dip_fw->bank[a], memofs, busy ? 0xc0 : 0x20 + (rand() % 8));
+	}
+}
+
+/* fill the receive buffers of one half frame the way the firmware does */
+static void dip_half(int frame, int first)
+{
+	int buf = (frame % 2) ? SNIFF_BUF_B : SNIFF_BUF_A;
+	int a;
+
+	station_frame(frame);
+	if (sweep)
+	{
+		dip_half_rssi(frame, first, buf);
+		return;
+	}
+
+	if (!(config.status & SNIFF_STATUS_INSYNC))
+	{
+		/* still hunting: the firmware receives into RAMBANK1 */
+		if (!first)
+			dip_receive(frame, station.slot, SC14421_RAMBANK1, 0);
+		return;
+	}
+
+	for (a = first; a < (first + 12); a++)
+	{
+		if (!(config.rxmask & (1 << a)))
+			continue;
+		dip_receive(frame, a, dev.dip_fw->bank[a], dev.dip_fw->memofs[a] + buf);
+	}
+}
+
+/* the carrier the emulated DIP tuned to, see dip_carrier() */
+static int emu_carrier(struct sc14421_dip *dip)
+{
+	int channel = (dip->synth >> 1) & 0x1f;
+
+	return (channel <= 10) ? 10 - channel : channel;
+}
+
+static int emu_burst(struct sc14421_dip *dip, int a)
+{
+	if (emu_carrier(dip) != station.channel)
+		return 0;
+	return (a == station.slot) || station_bearer(a % 12, dip->clock / DIP_FRAME);
+}
+
+static void emu_receive(struct sc14421_dip *dip, int a, unsigned char bank, int offset)
+{
+	if (sweep || (emu_carrier(dip) != station_carrier(a)))
+		return;
+	/* the A-field goes to offset, the status before it */
+	dip_receive(dip->clock / DIP_FRAME, a, bank, offset - 6);
+}
+
+static void emu_status(struct sc14421_dip *dip, int a, unsigned char bank, int offset)
+{
+	int busy = (emu_carrier(dip) == station.channel) &&
+		   ( ((a % 12) == station.slot) ||
+		     station_bearer(a % 12, dip->clock / DIP_FRAME) );
+
+	if (sweep)
+		sim_dip_write(&sim, bank, offset, busy ? 0xc0 : 0x20 + (rand() % 8));
+}
+
+static void run_irq(uint8_t irq, s64 stamp)
+{
+	uint64_t t0, t1;
+
+	sim_raise_irq(&sim, irq);
+	dev.irq_timestamp = stamp;
+
+	t0 = now_ns();
+	sniffer_irq_handler(&dev);
+	t1 = now_ns();
+	timing_add(&t_irq, t1 - t0);
+
+	if (dev.sniffer_tasklet.scheduled)
+	{
+		dev.sniffer_tasklet.scheduled = 0;
+		t0 = now_ns();
+		dev.sniffer_tasklet.func(dev.sniffer_tasklet.data);
+		t1 = now_ns();
+		timing_add(&t_bh, t1 - t0);
+	}
+}
+
+static unsigned long drain_ring(void)
+{
+	static char buf[COA_RING_SLOTSIZE * 64];
+	unsigned long records = 0;
+	ssize_t len;
+
+	while (coa_ring_reader_len(&dev.rx_ring, &reader))
+	{
+		len = coa_ring_read(&dev.rx_ring, &reader, buf, sizeof(buf));
+		if (len <= 0)
+			break;
+		if (sweep)
+		{
+			struct coa_rssi_row *row = (struct coa_rssi_row *) buf;
+			for (; (char *) row < buf + len; row++, records++)
+				rssi_map[row->index] = *row;
+			continue;
+		}
+		records += len / sizeof(struct sniffed_packet);
+	}
+	return records;
+}
+
+/* let the emulated DIP run the frames, take its interrupts as they come */
+static unsigned long run_emulated(unsigned long frames, unsigned long rate,
+				  s64 stamp, uint64_t start)
+{
+	uint64_t end = (uint64_t) frames * DIP_FRAME;
+	unsigned long records = 0;
+	int synced = 0;
+	uint8_t irq;
+
+	while (dip.clock < end)
+	{
+		dip.fw = dev.dip_fw;
+		station_frame(dip.clock / DIP_FRAME);
+		irq = dip_run(&dip, end);
+		if (!irq)
+			continue;
+
+		if ((irq & 0x01) && station.late && ((rand() % 100) < station.late))
+			sim_raise_irq(&sim, irq); /* handled with the next one */
+		else
+			run_irq(irq, stamp + dip.clock * DECT_FRAME_NS / DIP_FRAME);
+		records += drain_ring();
+
+		/* the slot costs only count once the table runs, the frame
+		 * after the driver patched it in or SLOTZERO lined it up */
+		if (!synced && (sweep || (config.status & SNIFF_STATUS_INSYNC)))
+			synced = dip.clock / DIP_FRAME + 2;
+		if ((synced > 1) && (dip.clock / DIP_FRAME >= synced))
+		{
+			synced = 1;
+			dip_clear_stats(&dip);
+		}
+
+		if (rate)
+		{
+			uint64_t due = start + (dip.clock / DIP_FRAME) * 1000000000ULL / rate;
+			uint64_t now = now_ns();
+			if (due > now)
+				usleep((due - now) / 1000);
+		}
+	}
+	return records;
+}
+
+static void usage(void)
+{
+	printf("usage: coa_sim [-f frames] [-c channel] [-s slot] [-t trafficslot]\n"
+	       "               [-e errorpercent] [-l latepercent] [-F framelatepercent]\n"
+	       "               [-r frames/s]\n"
+	       "               [-p pinnedslot] [-w] [-d [-L latency/us] [-v]] [-W] [-b]\n"
+	       "               [-H handoverframes] [-C setupframe]\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long frames = 1000;
+	unsigned long records = 0;
+	unsigned long rate = 0;
+	int pinned = -1;
+	unsigned long latency = 0;
+	int verbose = 0;
+	int burst = 1;
+	int bench = 0;
+	uint64_t start, elapsed;
+	s64 stamp = 1000000000LL;
+	unsigned long f;
+	uint8_t b;
+	int whole;
+	int c;
+
+	while ((c = getopt(argc, argv, "f:c:s:t:e:l:r:p:wdL:vWbH:C:F:")) != -1)
+	{
+		switch (c)
+		{
+		case 'f': frames = strtoul(optarg, NULL, 0); break;
+		case 'c': station.channel = atoi(optarg); break;
+		case 's': station.slot = atoi(optarg) % 12; break;
+		case 't': station.traffic = atoi(optarg) % 12; break;
+		case 'e': station.errors = atoi(optarg); break;
+		case 'l': station.late = atoi(optarg); break;
+		case 'F': station.frame_late = atoi(optarg); break;
+		case 'r': rate = strtoul(optarg, NULL, 0); break;
+		case 'w': sweep = 1; break;
+		case 'p': pinned = atoi(optarg); break;
+		case 'd': emulate = 1; break;
+		case 'L': latency = strtoul(optarg, NULL, 0); break;
+		case 'v': verbose = 1; break;
+		case 'W': burst = 0; break;
+		case 'b': bench = 1; break;
+		case 'H': station.handover = atoi(optarg); break;
+		case 'C': station.setup = atoi(optarg); break;
+		default: usage();
+		}
+	}
+	if (station.setup)
+	{
+		if (station.traffic < 0)
+			usage();
+		station.call_carrier = station_pscn(station.setup);
+	}
+
+	sim_reset(&sim);
+	sc14421_fw_init();
+
+	dip_reset(&dip, &sim);
+	dip.burst   = emu_burst;
+	dip.receive = emu_receive;
+	dip.status  = emu_status;
+	dip.latency = latency * DIP_FRAME / (DECT_FRAME_NS / 1000);
+	dip.verbose = verbose;
+
+	dev.sc14421_base = sim.window;
+	dev.config_base  = 1;
+	dev.bank         = SC14421_BANK_UNKNOWN;
+	dev.radio_type   = COA_RADIO_TYPE_II;
+	dev.radio        = sniffer_radio(dev.radio_type);
+	dev.open         = 1;
+	dev.operation_mode = COA_MODE_SNIFF | COA_SUBMODE_SNIFF_SYNC;
+	dev.sniffer_config = &config;
+	dev.sniffer_tasklet.func = sniffer_tasklet;
+	dev.sniffer_tasklet.data = (unsigned long) &dev;
+	if (coa_ring_alloc(&dev.rx_ring, 1024))
+	{
+		printf("couldn't coa_ring_alloc()\n");
+		return 1;
+	}
+	coa_ring_reader_init(&dev.rx_ring, &reader);
+
+	config.snifftype = sweep ? SNIFF_RSSI : SNIFF_SYNC;
+	config.channel   = station.channel;
+	config.rssi_carriers = COA_RSSI_CARRIERS_ALL;
+	config.pinned    = -1;
+	config.burst     = burst;
+	memcpy(config.RFPI, station.RFPI, sizeof(config.RFPI));
+
+	sniffer_init(&dev);
+	if (!sim_running(&sim))
+		printf("warning: sniffer_init() didn't start the DIP\n");
+	if (pinned >= 0)
+		sniffer_pin_slot(&dev, pinned);
+
+	start = now_ns();
+	if (emulate)
+		records = run_emulated(frames, rate, stamp, start);
+	for (f = 0; !emulate && (f < frames); f++)
+	{
+		/* the interrupts of a SlotTableB frame carry 0x04 */
+		b = (f % 2) ? SNIFF_IRQ_BUF_B : 0;
+		whole = station.frame_late && ((rand() % 100) < station.frame_late);
+
+		dip_half(f, 0);
+		if (whole || (station.late && ((rand() % 100) < station.late)))
+			sim_raise_irq(&sim, 0x01 | b); /* handled with the next one */
+		else
+			run_irq(0x01 | b, stamp + 12 * DECT_SLOT_NS);
+
+		dip_half(f, 12);
+		if (whole)
+			sim_raise_irq(&sim, 0x08 | b); /* a whole frame late */
+		else
+			run_irq(0x08 | b, stamp + 24 * DECT_SLOT_NS);
+
+		records += drain_ring();
+		stamp += DECT_FRAME_NS;
+
+		if (rate)
+		{
+			uint64_t due = start + (f + 1) * 1000000000ULL / rate;
+			uint64_t now = now_ns();
+			if (due > now)
+				usleep((due - now) / 1000);
+		}
+	}
+	elapsed = now_ns() - start;
+
+	printf("%lu frames in %llu ms, %.0f frames/s\n", frames,
+		(unsigned long long) (elapsed / 1000000),
+		elapsed ? frames * 1e9 / elapsed : 0.0);
+	if (sweep)
+	{
+		printf("%lu rssi rows read, last map:\n", records);
+		for (f = 0; f < config.rssi_count; f++)
+		{
+			printf("ch %2u sweep %4u:", rssi_map[f].channel, rssi_map[f].sweep);
+			for (c = 0; c < 24; c++)
+				printf(" %02x", rssi_map[f].rssi[c]);
+			printf("\n");
+		}
+	}
+	else
+	{
+		printf("sync status 0x%02x, %lu packets read\n", config.status, records);
+		if (dev.stats.beacon_unusable)
+			printf("%u beacons in a slot the firmware can't follow\n",
+				dev.stats.beacon_unusable);
+	}
+	timing_print("irq", &t_irq);
+	timing_print("tasklet", &t_bh);
+	printf("bank switches %u (%u per frame), %u elided\n",
+		dev.stats.bank_switches, dev.stats.bank_switches_frame,
+		dev.stats.bank_elided);
+	printf("patchloops %u, slot deaths %u, overruns %u (%u recovered, %u halves lost), ring drops %u\n",
+		dev.stats.patchloops, dev.stats.slot_deaths,
+		dev.stats.overruns, dev.stats.recovered,
+		dev.stats.overrun_lost, reader.drops);
+	if (station.setup)
+		printf("call setups %u, %u frames to the first B-field, %u at most\n",
+			dev.stats.call_setups, dev.stats.setup_frames,
+			dev.stats.setup_max);
+	if (station.handover)
+		printf("handovers %u, %u frames lost, %u at most\n",
+			dev.stats.handovers, dev.stats.handover_frames,
+			dev.stats.handover_max);
+	for (c = 0; c < 24; c++)
+		if (dev.stats.slot_ok[c] || dev.stats.slot_err[c])
+			printf("slot %2d: %u ok, %u errors\n", c,
+				dev.stats.slot_ok[c], dev.stats.slot_err[c]);
+	if (emulate)
+		dip_print_stats(&dip);
+	if (bench)
+	{
+		struct coa_read_bench rb = { .slots = 0 };
+
+		if (sniffer_read_bench(&dev, &rb))
+			printf("sniffer_read_bench() failed\n");
+		else
+			printf("%u slot reads: %u ns word by word, %u ns burst\n",
+				rb.slots, rb.word_ns, rb.burst_ns);
+	}
+
+	coa_ring_free(&dev.rx_ring);
+	return 0;
+}
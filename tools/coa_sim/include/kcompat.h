@@ -0,0 +1,193 @@
+/*
+ * coa_sim - run the com_on_air_cs sniffer on a simulated SC14421
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * authors:
+ * (C) 2008  Andreas Schuler <krater at badterrorist dot com>
+ * (C) 2008  Matthias Wenzel <dect at mazzoo dot de>
+ *
+ */
+
+/*
+ * just enough of the kernel API to build sc14421.c, sc14421_sniffer.c,
+ * sc14421_loader.c, dect.c, coa_ring.c and sc14421_firmware.c as a
+ * userspace program.
+ * every kernel header the driver includes maps to this file.
+ */
+
+#ifndef COA_SIM_KCOMPAT_H
+#define COA_SIM_KCOMPAT_H
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <time.h>
+
+#ifndef __LITTLE_ENDIAN
+# if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  define __LITTLE_ENDIAN 1234
+# else
+#  define __BIG_ENDIAN 4321
+# endif
+#endif
+
+#define __user
+#define __force
+#define __iomem
+#define __init
+#define __exit
+
+typedef int64_t  s64;
+typedef uint64_t u64;
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+typedef char    *caddr_t;
+typedef int64_t  ktime_t;
+
+#define printk(fmt, ...)	printf(fmt, ##__VA_ARGS__)
+#define KERN_INFO
+#define ARRAY_SIZE(a)		(sizeof(a) / sizeof((a)[0]))
+#define NSEC_PER_SEC		1000000000L
+#define NSEC_PER_MSEC		1000000L
+#define swab16(x)		((uint16_t)((((x) & 0xff) << 8) | (((x) >> 8) & 0xff)))
+
+#define min(a, b)		((a) < (b) ? (a) : (b))
+#define max(a, b)		((a) > (b) ? (a) : (b))
+#define min_t(t, a, b)		min((t) (a), (t) (b))
+
+#define PAGE_SIZE		4096UL
+#define PAGE_ALIGN(x)		(((x) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))
+
+/* one cpu, no concurrency: barriers only keep the compiler honest */
+#define barrier()		__asm__ __volatile__("" ::: "memory")
+#define smp_mb()		barrier()
+#define smp_rmb()		barrier()
+#define smp_wmb()		barrier()
+
+/* locks only count their holders, for lockdep_assert_held() */
+typedef struct { int held; } spinlock_t;
+#define spin_lock_init(l)		do { (l)->held = 0; } while (0)
+#define spin_lock(l)			do { (l)->held++; } while (0)
+#define spin_unlock(l)			do { (l)->held--; } while (0)
+#define spin_lock_irqsave(l, f)		do { (l)->held++; (f) = 0; } while (0)
+#define spin_unlock_irqrestore(l, f)	do { (l)->held--; (void)(f); } while (0)
+#define lockdep_assert_held(l)		assert((l)->held)
+
+struct mutex { int unused; };
+#define DEFINE_MUTEX(m)			struct mutex m
+#define mutex_lock(m)			do { (void)(m); } while (0)
+#define mutex_unlock(m)			do { (void)(m); } while (0)
+
+#define container_of(p, type, member) \
+	((type *)((char *)(p) - __builtin_offsetof(type, member)))
+
+struct kref { int refcount; };
+#define kref_init(k)		do { (k)->refcount = 1; } while (0)
+#define kref_get(k)		do { (k)->refcount++; } while (0)
+static inline int kref_put(struct kref *k, void (*release)(struct kref *))
+{
+	if (--k->refcount)
+		return 0;
+	release(k);
+	return 1;
+}
+
+#define GFP_KERNEL		0
+#define kzalloc(size, gfp)	calloc(1, (size))
+#define kfree(p)		free((void *)(p))
+#define simple_strtoul		strtoul
+
+/* the harness runs the tasklet itself, right after the interrupt */
+struct tasklet_struct
+{
+	void			(*func)(unsigned long);
+	unsigned long		data;
+	int			scheduled;
+};
+#define tasklet_schedule(t)	do { (t)->scheduled = 1; } while (0)
+#define tasklet_kill(t)		do { (t)->scheduled = 0; } while (0)
+
+/* the harness raises the interrupts itself, there is nothing to hold off */
+#define disable_irq(irq)	do { (void)(irq); } while (0)
+#define enable_irq(irq)		do { (void)(irq); } while (0)
+
+struct list_head { struct list_head *next, *prev; };
+typedef struct { int unused; } wait_queue_head_t;
+struct timer_list { int unused; };
+struct kfifo;
+struct dentry;
+struct pcmcia_device;
+struct file;
+struct inode;
+
+/* do_div() divides in place and returns the remainder */
+#define do_div(n, base) ({				\
+		uint32_t __rem = (uint64_t)(n) % (base);	\
+		(n) = (uint64_t)(n) / (base);			\
+		__rem;						\
+	})
+
+/* ktime_t is plain ns here */
+static inline ktime_t ktime_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ktime_t) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+#define ktime_sub(a, b)		((a) - (b))
+#define ktime_to_ns(t)		((s64) (t))
+
+/* the DIP memory window is an array */
+#define memcpy_fromio(dst, src, n)	memcpy((dst), (const void *) (src), (n))
+
+/* io ports: wait_4_IO_cycles() reads the config base */
+static inline unsigned char inb_p(unsigned long port)
+{
+	(void) port;
+	return 0;
+}
+
+/* the rx ring */
+static inline void *vmalloc_user(unsigned long size)
+{
+	return calloc(1, size);
+}
+#define vfree(p)		free(p)
+
+static inline unsigned long copy_to_user(void *to, const void *from,
+					 unsigned long n)
+{
+	memcpy(to, from, n);
+	return 0;
+}
+
+struct vm_area_struct
+{
+	unsigned long		vm_start;
+	unsigned long		vm_end;
+	unsigned long		vm_pgoff;
+	unsigned long		vm_flags;
+};
+
+#define VM_WRITE		0x00000002
+#define VM_MAYWRITE		0x00000020
+
+static inline int remap_vmalloc_range(struct vm_area_struct *vma,
+				      void *addr, unsigned long pgoff)
+{
+	(void) vma;
+	(void) addr;
+	(void) pgoff;
+	return -ENOSYS;
+}
+
+#endif
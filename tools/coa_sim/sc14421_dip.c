@@ -0,0 +1,563 @@
+/*
+ * coa_sim - run the com_on_air_cs sniffer on a simulated SC14421
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * authors:
+ * (C) 2008  Andreas Schuler <krater at badterrorist dot com>
+ * (C) 2008  Matthias Wenzel <dect at mazzoo dot de>
+ *
+ */
+
+/*
+ * executes the code bank of the simulated SC14421 the way the DIP would,
+ * as far as dip_opcodes.txt understands it, and keeps book of what each
+ * slot costs. the timing model:
+ *
+ *  - one clock is one DECT bit, a slot has 480 of them
+ *  - every instruction takes one clock, WT n takes n
+ *  - WNT n waits for the n-th slot boundary, SLOTZERO for slot 23. with
+ *    that numbering a receive the slot table prepares at PPn lands in
+ *    slot n, the slot before is spent tuning the radio
+ *  - B_SR opens a sync search that B_RST closes. a burst starting while
+ *    it is open sets the condition of JMP1 and moves the slot timing so
+ *    the current wait ends when that slot comes round again
+ *  - JMP1 is a conditional branch, the firmwares never return from it
+ *
+ * the code is read from the simulated code bank at every instruction, so
+ * the patches the driver writes while the DIP runs take effect as they
+ * would on the card.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "com_on_air.h"
+#include "dip_opcodes.h"
+#include "sc14421_sniffer.h"
+#include "sc14421_loader.h"
+#include "sc14421_dip.h"
+
+#define DIP_CODEBANK	0x20		/* SC14421_CODEBANK */
+
+/* an instruction's own clock, WT, or waiting for a slot */
+enum { DIP_INSN, DIP_WT, DIP_IDLE };
+
+static const struct
+{
+	unsigned char	op;
+	const char	*name;
+} dip_ops[] =
+{
+#define OP(x)	{ x, #x }
+	OP(BR), OP(JMP), OP(JMP1), OP(RTN), OP(BK_A1), OP(WNTM1), OP(WNTP1),
+	OP(WNT), OP(WT), OP(RFDIS), OP(RFEN), OP(LD_PTR), OP(SLOTZERO),
+	OP(BK_A), OP(BK_C),
+	OP(B_RST), OP(B_ST2), OP(B_XT), OP(B_BTFU), OP(B_XOFF), OP(B_XON),
+	OP(UNLCK), OP(B_SR), OP(B_XR), OP(EN_SL_ADJ), OP(B_BRFU), OP(B_RINV),
+	OP(B_RON),
+	OP(B_ST), OP(B_AT), OP(B_RC), OP(B_BT), OP(B_BTFP), OP(B_AT2),
+	OP(B_WRS), OP(B_AR), OP(B_BR), OP(B_BRFP), OP(B_AR2),
+	OP(D_RST), OP(D_ON), OP(D_OFF), OP(D_PREP), OP(WSC),
+	OP(D_LDK), OP(D_LDS), OP(D_WRS),
+	OP(U_PSC), OP(U_INT0), OP(RCK_INT), OP(RCK_EXT), OP(B_WB_OFF),
+	OP(B_WB_ON), OP(CLK1), OP(CLK3), OP(U_CK8), OP(U_CK4), OP(U_CK2),
+	OP(U_INT1), OP(U_CK1), OP(U_INT2), OP(U_INT3),
+	OP(A_RCV0), OP(A_RCV36), OP(A_RCV30), OP(A_RCV24), OP(A_RCV18),
+	OP(A_RCV12), OP(A_RCV6), OP(A_RCV33), OP(A_RCV27), OP(A_RCV21),
+	OP(A_RCV15), OP(A_RCV9), OP(A_RCV3),
+	OP(MEN3N), OP(MEN3), OP(MEN1N), OP(MEN1), OP(MEN2N), OP(MEN2),
+	OP(M_RD), OP(M_RST), OP(M_WRS), OP(M_WR),
+	OP(A_RST), OP(A_MUTE), OP(A_STOFF), OP(A_ALAW), OP(A_DT), OP(A_NORM),
+	OP(A_LDR), OP(A_LDW), OP(A_LIN), OP(A_MTOFF), OP(A_MUTE1),
+	OP(A_MTOFF1), OP(A_STON), OP(A_DT1), OP(A_LDR1), OP(A_LDW1),
+	OP(A_STRN), OP(P_LD), OP(P_EN), OP(P_SC), OP(A_RST1), OP(P_LDL),
+	OP(P_LDH), OP(C_ON), OP(C_OFF), OP(C_LD),
+#undef OP
+};
+
+static const char *dip_opname(unsigned char op)
+{
+	unsigned int i;
+
+	for (i = 0; i < sizeof(dip_ops) / sizeof(dip_ops[0]); i++)
+		if (dip_ops[i].op == op)
+			return dip_ops[i].name;
+	return NULL;
+}
+
+/* the name the firmware gives instruction i, if the driver patches it */
+static const char *dip_label(struct sc14421_dip *dip, int i)
+{
+	static char name[16];
+	const struct sc14421_fw *fw = dip->fw;
+	int n;
+
+	if (fw)
+	{
+		for (n = 0; n < 24; n++)
+		{
+			if (fw->jump[n] == i)
+				sprintf(name, "JP%d", n);
+			else if (fw->patch[n] == i)
+				sprintf(name, "PP%d", n);
+			else if (fw->patch_b[n] == i)
+				sprintf(name, "PP%dB", n);
+			else
+				continue;
+			return name;
+		}
+		if (fw->recv == i)
+			return "Recv";
+		if (fw->recv_b == i)
+			return "RecvB";
+		if (fw->recv_next == i)
+			return "RecvNext";
+		if (fw->pp_found == i)
+			return "PPFound";
+		if (fw->pp_search == i)
+			return "PPSearch";
+	}
+	sprintf(name, "%d", i);
+	return name;
+}
+
+static void dip_disasm(struct sc14421_dip *dip, char *buf, uint16_t op, uint16_t arg)
+{
+	const char *name = dip_opname(op);
+
+	if (!name)
+		sprintf(buf, "0x%02x 0x%02x", op, arg);
+	else if ((op == BR) || (op == JMP) || (op == JMP1))
+		sprintf(buf, "%s %s", name, dip_label(dip, arg));
+	else
+		sprintf(buf, "%s %u", name, arg);
+}
+
+static uint16_t dip_code(struct sc14421_dip *dip, int word)
+{
+	return sim_dip_read(dip->sim, DIP_CODEBANK, word) & 0xff;
+}
+
+/* BK_C selects half a RAM bank */
+static unsigned char dip_bank(struct sc14421_dip *dip)
+{
+	return ((dip->page >> 5) & 0x07) << 2;
+}
+
+static int dip_offset(struct sc14421_dip *dip, int arg)
+{
+	return ((dip->page & 0x10) ? 0x80 : 0x00) + arg;
+}
+
+static int dip_slot(struct sc14421_dip *dip)
+{
+	return (dip->clock / DIP_SLOT) % 24;
+}
+
+static void dip_print_mask(const char *what, uint32_t mask)
+{
+	int slot;
+
+	printf(" %s", what);
+	if (!mask)
+		printf(" none");
+	for (slot = 0; slot < 24; slot++)
+		if (mask & (1 << slot))
+			printf(" %d", slot);
+}
+
+/* log what changed since the last frame: patches, receives, late slots */
+static void dip_frame(struct sc14421_dip *dip)
+{
+	unsigned long frame = dip->clock / DIP_FRAME - 1;
+	char old[32], new[32];
+	uint16_t op, arg;
+	int i;
+
+	for (i = 0; i < DIP_CODE; i++)
+	{
+		op  = dip_code(dip, 2 * i);
+		arg = dip_code(dip, 2 * i + 1);
+		if ((op == dip->code[2 * i]) && (arg == dip->code[2 * i + 1]))
+			continue;
+
+		if (dip->verbose)
+		{
+			dip_disasm(dip, old, dip->code[2 * i], dip->code[2 * i + 1]);
+			dip_disasm(dip, new, op, arg);
+			printf("frame %lu: %s: %s -> %s\n", frame,
+				dip_label(dip, i), old, new);
+		}
+		dip->code[2 * i]     = op;
+		dip->code[2 * i + 1] = arg;
+		dip->patches++;
+	}
+
+	if (dip->verbose && ( (dip->rxmask != dip->last_rxmask) ||
+			      (dip->latemask != dip->last_latemask) ))
+	{
+		printf("frame %lu:", frame);
+		dip_print_mask("receives", dip->rxmask);
+		printf(",");
+		dip_print_mask("late", dip->latemask);
+		printf("\n");
+	}
+	dip->last_rxmask   = dip->rxmask;
+	dip->last_latemask = dip->latemask;
+	dip->rxmask   = 0;
+	dip->latemask = 0;
+}
+
+/* the clock just reached the start of a slot */
+static void dip_boundary(struct sc14421_dip *dip)
+{
+	int slot = dip_slot(dip);
+	int ended = (slot + 23) % 24;
+	struct dip_slot_stats *s = &dip->slot[ended];
+
+	if (dip->wait_kind == DIP_IDLE)
+	{
+		s->n++;
+		s->busy_sum += dip->busy;
+		if (dip->busy < s->busy_min)
+			s->busy_min = dip->busy;
+		if (dip->busy > s->busy_max)
+			s->busy_max = dip->busy;
+	}
+	else
+	{
+		s->late++;
+		dip->latemask |= 1 << ended;
+	}
+	dip->busy = 0;
+
+	if (!slot)
+		dip_frame(dip);
+
+	if (dip->searching && dip->burst && dip->burst(dip, slot))
+	{
+		dip->searching = 0;
+		dip->found = 1;
+		if (dip->wait_kind == DIP_IDLE)
+			dip->wait_until = dip->clock + DIP_FRAME;
+	}
+}
+
+static void dip_advance(struct sc14421_dip *dip, uint64_t to)
+{
+	uint64_t next;
+
+	while (dip->clock < to)
+	{
+		next = (dip->clock / DIP_SLOT + 1) * DIP_SLOT;
+		if (next > to)
+			next = to;
+		if (dip->wait_kind != DIP_IDLE)
+			dip->busy += next - dip->clock;
+		dip->clock = next;
+		if (!(dip->clock % DIP_SLOT))
+			dip_boundary(dip);
+	}
+}
+
+static void dip_raise(struct sc14421_dip *dip, int n)
+{
+	struct dip_irq_stats *s = &dip->irqs[n];
+	unsigned int at = dip->clock % DIP_FRAME;
+
+	if (!dip->irq)
+		dip->irq_clock = dip->clock;
+	dip->irq |= 1 << n;
+
+	s->n++;
+	if (at < s->at_min)
+		s->at_min = at;
+	if (at > s->at_max)
+		s->at_max = at;
+	if (s->last)
+	{
+		unsigned int every = dip->clock - s->last;
+		if (every < s->every_min)
+			s->every_min = every;
+		if (every > s->every_max)
+			s->every_max = every;
+	}
+	s->last = dip->clock;
+}
+
+static void dip_halt(struct sc14421_dip *dip, const char *why)
+{
+	printf("dip: %s at %d, clock %llu\n", why, dip->pc,
+		(unsigned long long) dip->clock);
+	dip->halted = 1;
+}
+
+static void dip_exec(struct sc14421_dip *dip)
+{
+	unsigned char op  = dip_code(dip, 2 * dip->pc);
+	unsigned char arg = dip_code(dip, 2 * dip->pc + 1);
+	struct dip_slot_stats *s = &dip->slot[dip_slot(dip)];
+	unsigned int in_slot = dip->clock % DIP_SLOT;
+	int next = dip->pc + 1;
+	int slot;
+
+	dip->wait_until = dip->clock + 1;
+	dip->wait_kind = DIP_INSN;
+
+	switch (op)
+	{
+	case BR:
+		next = arg;
+		break;
+	case JMP:
+		if (dip->sp == DIP_STACK)
+		{
+			dip_halt(dip, "stack overflow");
+			return;
+		}
+		dip->stack[dip->sp++] = next;
+		next = arg;
+		break;
+	case JMP1:
+		if (dip->found)
+			next = arg;
+		dip->found = 0;
+		break;
+	case RTN:
+		if (!dip->sp)
+		{
+			dip_halt(dip, "stack underflow");
+			return;
+		}
+		next = dip->stack[--dip->sp];
+		break;
+	case WT:
+		dip->wait_until = dip->clock + (arg ? arg : 1);
+		dip->wait_kind = DIP_WT;
+		break;
+	case WNT:
+		dip->wait_until = (dip->clock / DIP_SLOT + arg) * DIP_SLOT;
+		dip->wait_kind = DIP_IDLE;
+		break;
+	case SLOTZERO:
+		slot = dip_slot(dip);
+		if (slot == 23)
+		{
+			dip->wait_until = dip->clock;
+			break;
+		}
+		dip->wait_until = (dip->clock / DIP_FRAME) * DIP_FRAME + 23 * DIP_SLOT;
+		dip->wait_kind = DIP_IDLE;
+		dip->slips++;
+		break;
+	case BK_C:
+		dip->page = arg;
+		break;
+	case RFEN:
+		dip->rfen = 1;
+		break;
+	case M_WR:
+		if (dip->rfen)
+			dip->synth = sim_dip_read(dip->sim, dip_bank(dip), dip_offset(dip, arg));
+		dip->rfen = 0;
+		break;
+	case B_SR:
+		dip->searching = 1;
+		if (in_slot < s->sync_min)
+			s->sync_min = in_slot;
+		if (in_slot > s->sync_max)
+			s->sync_max = in_slot;
+		break;
+	case B_RST:
+		dip->searching = 0;
+		break;
+	case UNLCK:
+		dip->found = 0;
+		break;
+	case B_AR2:
+		s->rx++;
+		dip->rxmask |= 1 << dip_slot(dip);
+		if (dip->receive)
+			dip->receive(dip, dip_slot(dip), dip_bank(dip), dip_offset(dip, arg));
+		break;
+	case B_WRS:
+		if (dip->status)
+			dip->status(dip, dip_slot(dip), dip_bank(dip), dip_offset(dip, arg));
+		break;
+	case U_INT0:
+		dip_raise(dip, 0);
+		break;
+	case U_INT1:
+		dip_raise(dip, 1);
+		break;
+	case U_INT2:
+		dip_raise(dip, 2);
+		break;
+	case U_INT3:
+		dip_raise(dip, 3);
+		break;
+	default:
+		/* ports, radio, microwire, ciphering: only take their clock */
+		break;
+	}
+
+	if (next >= DIP_CODE)
+	{
+		dip_halt(dip, "ran off the code bank");
+		return;
+	}
+	dip->pc = next;
+}
+
+void dip_clear_stats(struct sc14421_dip *dip)
+{
+	int i;
+
+	memset(dip->slot, 0, sizeof(dip->slot));
+	memset(dip->irqs, 0, sizeof(dip->irqs));
+	for (i = 0; i < 24; i++)
+	{
+		dip->slot[i].busy_min = ~0;
+		dip->slot[i].sync_min = ~0;
+	}
+	for (i = 0; i < 4; i++)
+	{
+		dip->irqs[i].at_min    = ~0;
+		dip->irqs[i].every_min = ~0;
+	}
+	dip->slips   = 0;
+	dip->patches = 0;
+	dip->since   = dip->clock / DIP_FRAME;
+}
+
+void dip_reset(struct sc14421_dip *dip, struct sc14421_sim *sim)
+{
+	memset(dip, 0, sizeof(*dip));
+	dip->sim = sim;
+	dip_clear_stats(dip);
+}
+
+/*
+ * runs the DIP until the clock reaches until or the host takes an
+ * interrupt, returns the sources of that one. the host only gets to it
+ * while the DIP waits, so U_INT0 and U_INT2 arrive together.
+ */
+uint8_t dip_run(struct sc14421_dip *dip, uint64_t until)
+{
+	uint64_t target, deliver;
+	uint8_t irq;
+	int i;
+
+	while (dip->clock < until)
+	{
+		if (dip->starts != dip->sim->starts)
+		{
+			/* the driver stopped and restarted the DIP */
+			dip->starts    = dip->sim->starts;
+			dip->pc        = 0;
+			dip->sp        = 0;
+			dip->page      = 0;
+			dip->searching = 0;
+			dip->found     = 0;
+			dip->halted    = 0;
+			dip->wait_until = dip->clock;
+			for (i = 0; i < 2 * DIP_CODE; i++)
+				dip->code[i] = dip_code(dip, i);
+		}
+
+		if (!sim_running(dip->sim) || dip->halted)
+		{
+			dip->wait_kind = DIP_IDLE;
+			dip_advance(dip, until);
+			break;
+		}
+
+		if (dip->clock < dip->wait_until)
+		{
+			target = dip->wait_until;
+			if (target > until)
+				target = until;
+			if (dip->irq && (dip->wait_kind != DIP_INSN))
+			{
+				deliver = dip->irq_clock + dip->latency;
+				if (deliver <= dip->clock)
+					goto take;
+				if (deliver < target)
+					target = deliver;
+			}
+			dip_advance(dip, target);
+			continue;
+		}
+
+		dip_exec(dip);
+	}
+	return 0;
+
+take:
+	irq = dip->irq;
+	dip->irq = 0;
+	return irq;
+}
+
+static unsigned int dip_us(unsigned int clocks)
+{
+	return (unsigned long long) clocks * (DECT_FRAME_NS / 1000) / DIP_FRAME;
+}
+
+void dip_print_stats(struct sc14421_dip *dip)
+{
+	static const char *irq_names[4] = { "U_INT0", "U_INT1", "U_INT2", "U_INT3" };
+	struct dip_slot_stats *s;
+	struct dip_irq_stats *q;
+	unsigned int tightest = ~0;
+	int i, worst = -1;
+
+	printf("dip: %llu frames emulated, %lu since the stats, %lu patched instructions, %lu slips\n",
+		(unsigned long long) (dip->clock / DIP_FRAME),
+		(unsigned long) (dip->clock / DIP_FRAME - dip->since),
+		dip->patches, dip->slips);
+	printf("slot   busy min   avg   max  slack (us)  late    rx  B_SR at\n");
+	for (i = 0; i < 24; i++)
+	{
+		s = &dip->slot[i];
+		if (!s->n && !s->late)
+			continue;
+		printf("  %2d      ", i);
+		if (s->n)
+			printf("%3u   %3llu   %3u    %3u (%3u)", s->busy_min,
+				(unsigned long long) (s->busy_sum / s->n),
+				s->busy_max, DIP_SLOT - s->busy_max,
+				dip_us(DIP_SLOT - s->busy_max));
+		else
+			printf("  -     -     -      -      ");
+		printf(" %5lu %5lu", s->late, s->rx);
+		if (s->sync_max)
+			printf("  %3u..%3u", s->sync_min, s->sync_max);
+		printf("\n");
+
+		if (s->rx && s->n && (DIP_SLOT - s->busy_max < tightest))
+		{
+			tightest = DIP_SLOT - s->busy_max;
+			worst = i;
+		}
+	}
+	if (worst >= 0)
+		printf("tightest receive: slot %d, %u clocks (%u us) to spare\n",
+			worst, tightest, dip_us(tightest));
+
+	for (i = 0; i < 4; i++)
+	{
+		q = &dip->irqs[i];
+		if (!q->n)
+			continue;
+		printf("%s %7lu  at %2u.%03u..%2u.%03u", irq_names[i], q->n,
+			q->at_min / DIP_SLOT, q->at_min % DIP_SLOT,
+			q->at_max / DIP_SLOT, q->at_max % DIP_SLOT);
+		if (q->every_max)
+			printf("  every %u..%u clocks", q->every_min, q->every_max);
+		printf("\n");
+	}
+}
@@ -0,0 +1,103 @@
+/*
+ * coa_sim - run the com_on_air_cs sniffer on a simulated SC14421
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * authors:
+ * (C) 2008  Andreas Schuler <krater at badterrorist dot com>
+ * (C) 2008  Matthias Wenzel <dect at mazzoo dot de>
+ *
+ */
+
+#ifndef SC14421_DIP_H
+#define SC14421_DIP_H
+
+#include <stdint.h>
+
+#include "sc14421_sim.h"
+
+struct sc14421_fw;
+
+/* one clock is one DECT bit */
+#define DIP_SLOT		480
+#define DIP_FRAME		(24 * DIP_SLOT)
+#define DIP_STACK		4
+#define DIP_CODE		254		/* instructions in the code bank */
+
+struct dip_slot_stats
+{
+	unsigned long	n;		/* slots ended waiting */
+	unsigned long	late;		/* slots ended busy */
+	unsigned long	rx;		/* B_AR2 in this slot */
+	uint64_t	busy_sum;
+	unsigned int	busy_min;
+	unsigned int	busy_max;
+	unsigned int	sync_min;	/* B_SR, clocks into the slot */
+	unsigned int	sync_max;
+};
+
+struct dip_irq_stats
+{
+	unsigned long	n;
+	unsigned int	at_min;		/* clocks into the frame */
+	unsigned int	at_max;
+	uint64_t	last;
+	unsigned int	every_min;	/* clocks since the last one */
+	unsigned int	every_max;
+};
+
+struct sc14421_dip
+{
+	struct sc14421_sim	*sim;
+	const struct sc14421_fw	*fw;		/* labels for the patch log */
+
+	/* the air: does a burst start in slot on the tuned carrier? */
+	int	(*burst)(struct sc14421_dip *dip, int slot);
+	/* B_AR2 stored a slot at offset of bank, B_WRS its status */
+	void	(*receive)(struct sc14421_dip *dip, int slot, unsigned char bank, int offset);
+	void	(*status)(struct sc14421_dip *dip, int slot, unsigned char bank, int offset);
+
+	uint64_t	clock;
+	uint64_t	latency;	/* clocks until the host takes an irq */
+	int		verbose;	/* log patches and schedule changes */
+	unsigned long	starts;		/* sim->starts we last saw */
+	int		halted;
+
+	int		pc;
+	int		stack[DIP_STACK];
+	int		sp;
+	unsigned char	page;		/* BK_C */
+
+	uint64_t	wait_until;
+	int		wait_kind;	/* what the DIP waits in, see dip_exec() */
+
+	int		rfen;		/* next M_WR tunes the synthesizer */
+	uint16_t	synth;		/* the word it was tuned with */
+	int		searching;	/* B_SR .. B_RST */
+	int		found;		/* for JMP1 */
+
+	uint8_t		irq;		/* raised, not taken by the host yet */
+	uint64_t	irq_clock;
+
+	/* statistics, see dip_print_stats() */
+	unsigned long	since;		/* frame of the last dip_clear_stats() */
+	unsigned int	busy;		/* clocks used in the current slot */
+	uint32_t	rxmask;		/* slots of the current frame */
+	uint32_t	latemask;
+	uint32_t	last_rxmask;
+	uint32_t	last_latemask;
+	uint16_t	code[2 * DIP_CODE];	/* for the patch log */
+	unsigned long	patches;
+	unsigned long	slips;		/* SLOTZERO waited more than a slot */
+	struct dip_slot_stats	slot[24];
+	struct dip_irq_stats	irqs[4];
+};
+
+void    dip_reset(struct sc14421_dip *dip, struct sc14421_sim *sim);
+void    dip_clear_stats(struct sc14421_dip *dip);
+uint8_t dip_run(struct sc14421_dip *dip, uint64_t until);
+void    dip_print_stats(struct sc14421_dip *dip);
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * coa_sim - run the com_on_air_cs sniffer on a simulated SC14421
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * authors:
+ * (C) 2008  Andreas Schuler <krater at badterrorist dot com>
+ * (C) 2008  Matthias Wenzel <dect at mazzoo dot de>
+ *
+ */
+
+/*
+ * the host sees the SC14421 memory through a 512 word window. word 511
+ * selects which bank is mapped (write) and returns the pending interrupt
+ * sources (read). the driver accesses the window directly through
+ * pointers, so the window is a real array here and a bank switch copies
+ * the banks in and out of it.
+ */
+
+#include <string.h>
+
+#include "sc14421_sim.h"
+
+static int sim_bank_index(unsigned char bank)
+{
+	if (bank & 0x20) /* SC14421_CODEBANK */
+		return SIM_CODEBANK;
+	return (bank >> 2) & 0x07;
+}
+
+static struct sc14421_sim *sim_from_base(volatile uint16_t *sc14421_base)
+{
+	return (struct sc14421_sim *) sc14421_base;
+}
+
+void sim_reset(struct sc14421_sim *sim)
+{
+	memset(sim, 0, sizeof(*sim));
+	sim->bankreg = 0x80; /* SC14421_DIPSTOPPED */
+}
+
+int sim_running(struct sc14421_sim *sim)
+{
+	return !(sim->bankreg & 0x80);
+}
+
+void sim_dip_write(struct sc14421_sim *sim, unsigned char bank, int offset, uint16_t value)
+{
+	int idx = sim_bank_index(bank);
+
+	if (idx == sim->cur)
+		sim->window[offset] = value;
+	else
+		sim->ram[idx][offset] = value;
+}
+
+uint16_t sim_dip_read(struct sc14421_sim *sim, unsigned char bank, int offset)
+{
+	int idx = sim_bank_index(bank);
+
+	if (idx == sim->cur)
+		return sim->window[offset];
+	return sim->ram[idx][offset];
+}
+
+void sim_raise_irq(struct sc14421_sim *sim, uint8_t irq)
+{
+	sim->irq |= irq;
+}
+
+/* called by SC14421_switch_to_bank() when built with COA_SIMULATE */
+void sc14421_sim_switch_to_bank(volatile uint16_t *sc14421_base, unsigned char bank)
+{
+	struct sc14421_sim *sim = sim_from_base(sc14421_base);
+	int idx = sim_bank_index(bank);
+
+	if ((sim->bankreg & 0x80) && !(bank & 0x80))
+		sim->starts++;
+	sim->bankreg = bank;
+	sim->switches++;
+
+	if (idx == sim->cur)
+		return;
+
+	memcpy(sim->ram[sim->cur], sim->window, SIM_BANKREG * sizeof(uint16_t));
+	memcpy(sim->window, sim->ram[idx], SIM_BANKREG * sizeof(uint16_t));
+	sim->cur = idx;
+}
+
+/* called by SC14421_clear_interrupt(), reading the sources clears them */
+uint8_t sc14421_sim_clear_interrupt(volatile uint16_t *sc14421_base)
+{
+	struct sc14421_sim *sim = sim_from_base(sc14421_base);
+	uint8_t irq = sim->irq & 0x0f;
+
+	sim->irq = 0;
+	return irq;
+}
@@ -0,0 +1,46 @@
+/*
+ * coa_sim - run the com_on_air_cs sniffer on a simulated SC14421
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * authors:
+ * (C) 2008  Andreas Schuler <krater at badterrorist dot com>
+ * (C) 2008  Matthias Wenzel <dect at mazzoo dot de>
+ *
+ */
+
+#ifndef SC14421_SIM_H
+#define SC14421_SIM_H
+
+#include <stdint.h>
+
+#define SIM_WORDS	512		/* one bank as seen by the host */
+#define SIM_BANKS	9		/* RAMBANK0..7 and the code bank */
+#define SIM_CODEBANK	8
+#define SIM_BANKREG	511
+
+struct sc14421_sim
+{
+	/* the host's memory window, dev->sc14421_base points here.
+	 * must stay the first member, see sim_from_base() */
+	uint16_t	window[SIM_WORDS];
+
+	uint16_t	ram[SIM_BANKS][SIM_WORDS];
+	int		cur;		/* bank shown in window[] */
+	unsigned char	bankreg;	/* last value written to word 511 */
+	uint8_t		irq;		/* pending interrupt sources */
+	unsigned long	switches;
+	unsigned long	starts;		/* DIP started, see sc14421_dip.c */
+};
+
+void     sim_reset(struct sc14421_sim *sim);
+int      sim_running(struct sc14421_sim *sim);
+
+/* the DIP side: what the firmware would write after receiving a slot */
+void     sim_dip_write(struct sc14421_sim *sim, unsigned char bank, int offset, uint16_t value);
+uint16_t sim_dip_read(struct sc14421_sim *sim, unsigned char bank, int offset);
+void     sim_raise_irq(struct sc14421_sim *sim, uint8_t irq);
+
+#endif
@@ -31,16 +31,6 @@
 
 #include "com_on_air_user.h"
 
-
-struct sniffed_packet
-{
-	unsigned char     rssi;
-	unsigned char     channel;
-	unsigned char     slot;
-	struct timespec   timestamp;
-	unsigned char     data[53];
-};
-
 struct pcap_global_header
 { 
 	uint32_t magic_number;   /* magic number */
@@ -89,6 +79,7 @@ int main(int argc, char *argv[])
 {
 	int d;
 	int ret = 0;
+	const char *dev = getenv("COA_DEV"); /* e.g. /dev/coa1 */
 
 	FILE *pcap;
 	if(argc<2)
@@ -97,10 +88,13 @@ int main(int argc, char *argv[])
 		exit(-1);	
 	}
 
-	d=open(DEV, O_RDONLY);
+	if (!dev)
+		dev = DEV;
+
+	d=open(dev, O_RDONLY);
 	if (d<0)
 	{
-		printf("couldn't open(\"%s\"): %s\n", DEV, strerror(errno));
+		printf("couldn't open(\"%s\"): %s\n", dev, strerror(errno));
 		exit(1);
 	}
 
@@ -132,30 +126,50 @@ int main(int argc, char *argv[])
 	printf("set channel %u\n",chn);
 	if(ioctl(d,COA_IOCTL_CHAN,&chn)){printf("couldn't set channel\n");exit(1);}
 
+	//wake up once per frame, not once per packet
+	struct coa_watermark wm={24,10000};
+	if(ioctl(d,COA_IOCTL_WATERMARK,&wm)){printf("couldn't set watermark\n");exit(1);}
+
+
+	//get a whole burst of packets per read()
+	uint32_t mode=COA_READ_BATCH;
+	if(ioctl(d,COA_IOCTL_READMODE,&mode)){printf("couldn't set read mode\n");exit(1);}
+
 
 	write_global_header(pcap);
 
 	//sniff-loop
         while (0xDEC + 't')
 	{
-		struct sniffed_packet buf;
-	        while (sizeof(struct sniffed_packet) == (ret = read(d, &buf, (sizeof(struct sniffed_packet)))))
+		unsigned char buf[sizeof(struct coa_batch_header) + 64*sizeof(struct sniffed_packet)];
+		struct coa_batch_header *batch = (struct coa_batch_header *)buf;
+		struct sniffed_packet *p = (struct sniffed_packet *)(buf + sizeof(*batch));
+		uint32_t i;
+
+		ret = read(d, buf, sizeof(buf));
+		if ((ret < (int)sizeof(*batch)) || (batch->reclen != sizeof(struct sniffed_packet)))
+			continue;
+
+		if (batch->drops)
+			printf("lost %u packets\n", batch->drops);
+
+		for (i=0; i<batch->count; i++, p++)
 		{
 	        	unsigned char packet[100];
 			packet[12]=0x23;
 			packet[13]=0x23;
 			packet[14]=0x00;		//decttype (receive)
-			packet[15]=buf.channel;		//channel
+			packet[15]=p->channel;		//channel
 			packet[16]=0;
-			packet[17]=buf.slot;		//slot
+			packet[17]=p->slot;		//slot
 			packet[18]=0;
-			packet[19]=buf.rssi;
-			memcpy(packet+20,buf.data,53);
+			packet[19]=p->rssi;
+			memcpy(packet+20,p->data,53);
 
 			write_record(
 				pcap,
-				buf.timestamp.tv_sec,
-				buf.timestamp.tv_nsec/1000,
+				p->timestamp.tv_sec,
+				p->timestamp.tv_nsec/1000,
 				73,
 				packet);
 		}
@@ -164,7 +178,6 @@ int main(int argc, char *argv[])
 
 
 
-
 	return ret;
 }
 
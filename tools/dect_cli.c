@@ -54,7 +54,10 @@ void print_help(void)
 	LOG("   autorec       - sync on any calls in callscan, autodump in pcap\n");
 	LOG("   ppscan <rfpi> - sync scan for active calls\n");
 	LOG("   chan <ch>     - set current channel [0-9], currently %d\n", cli.channel);
-//	LOG("   slot <sl>     - set current slot [0-23], currently %d\n", cli.slot);
+	LOG("   slot <sl>     - only follow slot pair [0-23] in ppscan, \"any\" for all\n");
+	LOG("   firmware      - load the DIP programs from /lib/firmware/coa,\n");
+	LOG("                   \"firmware builtin\" for the ones in the driver\n");
+	LOG("   readbench [n] - time n DIP slot buffer reads, in ppscan\n");
 //	LOG("   jam           - jam current channel\n");
 	LOG("   ignore <rfpi> - toggle ignoring of an RFPI in autorec\n");
 	LOG("   dump          - dump stations and calls we have seen\n");
@@ -82,7 +85,11 @@ void set_channel(uint32_t channel)
 
 void set_slot(uint32_t slot)
 {
-	LOG("!!! not yet implemented :(\n");
+	if (cli.verbose)
+		LOG("### pinning slot %d\n", slot);
+	if (ioctl(cli.fd, COA_IOCTL_SLOT, &slot)){
+		LOG("!!! couldn't ioctl(), not in ppscan?\n");
+	}
 }
 
 void do_ppscan(uint8_t * RFPI)
@@ -123,7 +130,8 @@ void add_station(struct dect_station * station)
 	LOG("### found new %s", station->type == TYPE_FP ? "station":"call on");
 	for (i=0; i<5; i++)
 		LOG(" %.2x", station->RFPI[i]);
-	LOG(" on channel %d RSSI %d\n", station->channel, station->RSSI);
+	LOG(" on channel %d RSSI %d\n", station->channel,
+			station->RSSI / station->count_seen);
 
 	struct dect_station * p = cli.station_list;
 	if (p)
@@ -150,7 +158,7 @@ void add_station(struct dect_station * station)
 	p->type = station->type;
 	p->first_seen = time(NULL);
 	p->last_seen = p->first_seen;
-	p->count_seen = 1;
+	p->count_seen = station->count_seen;
 }
 
 void try_add_station(struct dect_station * station)
@@ -176,7 +184,7 @@ void try_add_station(struct dect_station * station)
 				}
 				found = 1;
 				p->channel = station->channel;
-				p->count_seen++;
+				p->count_seen += station->count_seen;
 				p->last_seen = time(NULL);
 				p->RSSI += station->RSSI; /* we avg on dump */
 			}
@@ -204,6 +212,16 @@ void try_add_station(struct dect_station * station)
 }
 
 
+/* let the driver aggregate the beacons of each station */
+void set_scan_summary(void)
+{
+	uint32_t period = SCAN_SUMMARY_MS;
+	if (ioctl(cli.fd, COA_IOCTL_SCANAGG, &period)){
+		LOG("!!! couldn't ioctl()\n");
+		exit(1);
+	}
+}
+
 void do_fpscan(void)
 {
 	LOG("### starting fpscan\n");
@@ -213,6 +231,7 @@ void do_fpscan(void)
 		LOG("!!! couldn't ioctl()\n");
 		exit(1);
 	}
+	set_scan_summary();
 	/* set start channel */
 	set_channel(cli.channel);
 	cli.mode = MODE_FPSCAN;
@@ -228,6 +247,7 @@ void do_callscan(void)
 		LOG("!!! couldn't ioctl()\n");
 		exit(1);
 	}
+	set_scan_summary();
 	/* set start channel */
 	set_channel(cli.channel);
 	cli.mode = MODE_CALLSCAN;
@@ -395,6 +415,14 @@ void do_slot(char * str_slot)
 {
 	uint32_t slot;
 	char * end;
+	while (*str_slot == ' ')
+		str_slot++;
+	if (!strncasecmp(str_slot, "any", 3))
+	{
+		cli.slot = COA_SLOT_ANY;
+		set_slot(cli.slot);
+		return;
+	}
 	errno = 0;
 	slot = strtoul(str_slot, &end, 0);
 	if ((errno == ERANGE && (slot == LONG_MAX || slot == LONG_MIN))
@@ -417,6 +445,38 @@ void do_slot(char * str_slot)
 	set_slot(cli.slot);
 }
 
+void do_firmware(char * str_source)
+{
+	uint32_t source = COA_FIRMWARE_LOAD;
+	while (*str_source == ' ')
+		str_source++;
+	if (!strncasecmp(str_source, "builtin", 7))
+		source = COA_FIRMWARE_BUILTIN;
+	if (ioctl(cli.fd, COA_IOCTL_FIRMWARE, &source))
+	{
+		LOG("!!! couldn't load the firmware: %s\n", strerror(errno));
+		return;
+	}
+	LOG("### firmware %s\n", source == COA_FIRMWARE_BUILTIN ?
+			"builtin" : "loaded");
+}
+
+void do_readbench(char * str_slots)
+{
+	struct coa_read_bench bench;
+
+	memset(&bench, 0, sizeof(bench));
+	bench.slots = strtoul(str_slots, NULL, 0);
+	if (ioctl(cli.fd, COA_IOCTL_READ_BENCH, &bench))
+	{
+		LOG("!!! couldn't ioctl(): %s, not in ppscan?\n", strerror(errno));
+		return;
+	}
+	LOG("### %u slot reads: %u ns word by word, %u ns burst, using %s\n",
+			bench.slots, bench.word_ns, bench.burst_ns,
+			bench.burst ? "burst" : "word by word");
+}
+
 void do_jam(void)
 {
 	LOG("!!! not yet implemented :(\n");
@@ -590,6 +650,10 @@ void process_cli_data()
 		{ do_chan(&buf[4]); done = 1; }
 	if ( !strncasecmp((char *)buf, "slot", 4) )
 		{ do_slot(&buf[4]); done = 1; }
+	if ( !strncasecmp((char *)buf, "firmware", 8) )
+		{ do_firmware(&buf[8]); done = 1; }
+	if ( !strncasecmp((char *)buf, "readbench", 9) )
+		{ do_readbench(&buf[9]); done = 1; }
 	if ( !strncasecmp((char *)buf, "jam", 3) )
 		{ do_jam(); done = 1; }
 	if ( !strncasecmp((char *)buf, "ignore", 6) )
@@ -657,28 +721,32 @@ int has_b_field()
 	return 0;
 }
 
+/* the scan modes report every station once and then once per
+ * SCAN_SUMMARY_MS, see set_scan_summary() */
+void read_scan_stations(int type)
+{
+	struct coa_scan_station st;
+
+	while (sizeof(st) == read(cli.fd, &st, sizeof(st)))
+	{
+		memcpy(cli.station.RFPI, st.RFPI, 5);
+		cli.station.channel = st.channel;
+		cli.station.RSSI = st.rssi_sum;
+		cli.station.count_seen = st.count;
+		cli.station.type = type;
+		try_add_station(&cli.station);
+	}
+}
+
 void process_dect_data()
 {
-	int ret;
 	switch (cli.mode)
 	{
 		case MODE_FPSCAN:
-			while (7 == (ret = read(cli.fd, buf, 7))){
-				memcpy(cli.station.RFPI, &buf[2], 5);
-				cli.station.channel = buf[0];	
-				cli.station.RSSI = buf[1];
-				cli.station.type = TYPE_FP;
-				try_add_station(&cli.station);
-			}
+			read_scan_stations(TYPE_FP);
 			break;
 		case MODE_CALLSCAN:
-			while (7 == (ret = read(cli.fd, buf, 7))){
-				memcpy(cli.station.RFPI, &buf[2], 5);
-				cli.station.channel = buf[0];
-				cli.station.RSSI = buf[1];
-				cli.station.type = TYPE_PP;
-				try_add_station(&cli.station);
-			}
+			read_scan_stations(TYPE_PP);
 			break;
 		case MODE_PPSCAN:
 			while ( sizeof(cli.packet) ==
@@ -687,6 +755,7 @@ void process_dect_data()
 				memcpy(cli.station.RFPI, cli.RFPI, 5);
 				cli.station.channel = cli.packet.channel;
 				cli.station.RSSI = cli.packet.rssi;
+				cli.station.count_seen = 1;
 				cli.station.type = TYPE_PP;
 				/* to ypdate statistics only we try_add_station() */
 				try_add_station(&cli.station);
@@ -717,13 +786,9 @@ void process_dect_data()
 				struct pcap_pkthdr pcap_hdr;
 				pcap_hdr.caplen = 73;
 				pcap_hdr.len = 73;
-				ret = gettimeofday(&pcap_hdr.ts, NULL);
-				if (ret)
-				{
-					LOG("!!! couldn't gettimeofday(): %s\n",
-							strerror(errno));
-					exit(1);
-				}
+				/* the driver stamps every slot, no need to ask the clock again */
+				pcap_hdr.ts.tv_sec  = cli.packet.timestamp.tv_sec;
+				pcap_hdr.ts.tv_usec = cli.packet.timestamp.tv_nsec / 1000;
 				uint8_t pcap_packet[100];
 				memset(pcap_packet, 0, 100);
 				pcap_packet[12] = 0x23;
@@ -749,11 +814,16 @@ void process_dect_data()
 
 void init_dect()
 {
-	cli.fd = open(DEV, O_RDWR | O_NONBLOCK);
+	const char *dev = getenv("COA_DEV"); /* e.g. /dev/coa1 */
+
+	if (!dev)
+		dev = DEV;
+
+	cli.fd = open(dev, O_RDWR | O_NONBLOCK);
 	if (cli.fd < 0)
 	{
 		LOG("!!! couldn't open(\"%s\"): %s\n",
-				DEV,
+				dev,
 				strerror(errno));
 		exit(1);
 	}
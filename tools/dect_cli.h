@@ -23,6 +23,9 @@
 #define TYPE_FP 23
 #define TYPE_PP 42
 
+/* one record per station and period, see COA_IOCTL_SCANAGG */
+#define SCAN_SUMMARY_MS 1000
+
 struct dect_station
 {
 	struct dect_station   * next;
@@ -35,17 +38,6 @@ struct dect_station
 	uint32_t              count_seen;
 };
 
-struct sniffed_packet
-{
-   unsigned char     rssi;
-   unsigned char     channel;
-   unsigned char     slot;
-   unsigned char     framenumber;
-   unsigned char     bfok;
-   struct timespec   timestamp;
-   unsigned char     data[53];
-};
-
 
 struct rfpi_list
 {
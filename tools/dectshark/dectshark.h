@@ -41,16 +41,4 @@ void printnil(char *,...);
 #endif
 
 
-struct sniffed_packet
-{
-   unsigned char     rssi;
-   unsigned char     channel;
-   unsigned char     slot;
-   unsigned char     framenumber;
-   unsigned char     bfok;
-   struct timespec   timestamp;
-   unsigned char     data[53];
-};
-
-
 #endif
@@ -30,9 +30,9 @@ void found_dects::AddDect(dect_found found)
 			if(!memcmp(list[i].RFPI,found.RFPI,5))
 			{
 				if(found.type==DECT_FOUND_FP)
-					list[i].fppackets++;
+					list[i].fppackets+=found.count;
 				else
-					list[i].pppackets++;
+					list[i].pppackets+=found.count;
 
 				list[i].rssi=found.rssi;
 
@@ -15,6 +15,7 @@ struct dect_found
 	unsigned char	RFPI[5];
 	char		channel;	
 	unsigned char	rssi;
+	unsigned int	count;		/* packets this one stands for */
 };
 
 
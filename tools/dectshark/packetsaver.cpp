@@ -70,7 +70,7 @@ void packetsaver::closefile()
 void packetsaver::savepacket(sniffed_packet packet)
 {
 	struct pcap_pkthdr pcap_hdr;
-	int ret,length;
+	int length;
 
 	if(pcap_d)
 	{
@@ -81,13 +81,8 @@ void packetsaver::savepacket(sniffed_packet packet)
 
 		pcap_hdr.caplen = length;
 		pcap_hdr.len = length;
-		ret = gettimeofday(&pcap_hdr.ts, NULL);
-		if (ret)
-		{
-			LOG("!!! couldn't gettimeofday(): %s\n",
-			strerror(errno));
-			exit(1);
-		}
+		pcap_hdr.ts.tv_sec = packet.timestamp.tv_sec;
+		pcap_hdr.ts.tv_usec = packet.timestamp.tv_nsec / 1000;
 
 		uint8_t pcap_packet[74];
 		memset(pcap_packet, 0, 74);
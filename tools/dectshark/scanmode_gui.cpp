@@ -242,12 +242,13 @@ void scanmode_gui::down()
 
 void *scanthread(void *threadid)
 {
-	int channeltime=0;
+	struct timeval tv, now, lasthop;
+	fd_set rfd;
   	int dev;
 
 	founds.ClearList();
 
-        dev = open(DEV, O_RDONLY);
+        dev = open(DEV, O_RDONLY | O_NONBLOCK);
 	if (dev<0)
 	{
 		printf("couldn't open(\"%s\"): %s\n", DEV, strerror(errno));
@@ -268,22 +269,41 @@ void *scanthread(void *threadid)
 		printf("couldn't set sniff mode\n");
 	}
 
+	/* one record per station and period instead of one per packet */
+	uint32_t period = 500;
+	if (ioctl(dev, COA_IOCTL_SCANAGG, &period))
+	{
+		printf("couldn't set scan summary period\n");
+	}
+
+	gettimeofday(&lasthop, NULL);
 
 	while(0xDEC + 'T')		// ;)
 	{
 		dect_found found;
 		
-		unsigned char buf[7];
-		while (7 == (read(dev, buf, 7)))
+		struct coa_scan_station st;
+
+		FD_ZERO(&rfd);
+		FD_SET(dev, &rfd);
+
+		/* wake up in time for cfg.shouldstop() and the next hop */
+		tv.tv_sec  = 0;
+		tv.tv_usec = 100000;
+
+		if (select(dev+1, &rfd, NULL, NULL, &tv) > 0)
 		{
-			memcpy(found.RFPI,buf+2,5);
-			found.channel=buf[0];
-			found.type=DECT_FOUND_FP;
-			found.rssi=buf[1];
-			founds.AddDect(found);
+			while (sizeof(st) == (read(dev, &st, sizeof(st))))
+			{
+				memcpy(found.RFPI,st.RFPI,5);
+				found.channel=st.channel;
+				found.type=DECT_FOUND_FP;
+				found.rssi=st.rssi_sum/st.count;
+				found.count=st.count;
+				founds.AddDect(found);
+			}
 		}
 		
-		usleep(100000);
 		if(cfg.shouldstop())
 		{
 			close(dev);
@@ -291,9 +311,9 @@ void *scanthread(void *threadid)
 			pthread_exit(NULL);
 		}
 
-		channeltime++;
-	
-		if(channeltime == 8)
+		gettimeofday(&now, NULL);
+		if(((now.tv_sec - lasthop.tv_sec) * 1000000 +
+		    (now.tv_usec - lasthop.tv_usec)) >= 800000)
 		{
 			if(cfg.hop())
 			{
@@ -313,7 +333,7 @@ void *scanthread(void *threadid)
 				cfg.setwantchannel(-1);
 			}
 
-			channeltime = 0;
+			lasthop = now;
 		}
 	}
 
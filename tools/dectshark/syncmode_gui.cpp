@@ -268,10 +268,17 @@ void *syncthread(void *threadid)
 
   	int dev;
 
-   dev = open(DEV, O_RDONLY);
+   dev = open(DEV, O_RDONLY | O_NONBLOCK);
 	if (dev<0)
 		printf("couldn't open(\"%s\"): %s\n", DEV, strerror(errno));
 
+	/* one wakeup per half frame is plenty for the gui */
+	struct coa_watermark wm;
+	wm.packets = 12;
+	wm.usecs   = 5000;
+	if (ioctl(dev, COA_IOCTL_WATERMARK, &wm))
+		printf("couldn't set watermark\n");
+
 	uint16_t val;
 
 	val=COA_MODE_SNIFF|COA_SUBMODE_SNIFF_SYNC;
@@ -314,8 +321,6 @@ void *syncthread(void *threadid)
 			process_dect_data(dev);
 		}
 
-
-		usleep(100);
       if(cfg.shouldstop())
       {
          close(dev);